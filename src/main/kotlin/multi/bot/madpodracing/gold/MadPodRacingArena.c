@@ -0,0 +1,380 @@
+// Mad Pod Racing 로컬 심판 (오프라인 자체 대전 토너먼트)
+//
+// 빌드: gcc -std=gnu11 -O2 -o arena MadPodRacingArena.c -lm
+// 사용: ./arena <봇A 실행 파일> <봇B 실행 파일> [게임 수=1000] [워커 수=코어 수] [시드=1]
+//
+// 무작위 트랙을 만들어 두 봇을 자식 프로세스로 실행하고 stdin/stdout 파이프로 대전시킴
+// 물리는 MadPodRacingGold.c의 시뮬레이션 엔진을 그대로 사용 (심판과 동일한 계산)
+// 같은 트랙을 진영을 바꿔 두 번씩 진행하고, 승률(윌슨 95% 신뢰구간)과 게임별 시간을 출력
+// 환경 변수 BOT_RECORD를 지정하면 봇마다 "<BOT_RECORD>.<게임 번호>.<A|B>" 경로에 리플레이 로그를 남김
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define main botMain
+#include "MadPodRacingGold.c"
+#undef main
+
+#define ARENA_LAPS 3
+#define ARENA_MIN_CHECKPOINTS 3
+#define ARENA_MAX_CHECKPOINTS 8
+#define ARENA_MAP_WIDTH 16000
+#define ARENA_MAP_HEIGHT 9000
+#define ARENA_CHECKPOINT_GAP 2500      // 체크포인트 사이 최소 거리
+#define ARENA_MAX_TURNS 600            // 이 턴 수를 넘기면 무승부
+#define ARENA_TURN_LIMIT_MS 75
+#define ARENA_FIRST_TURN_LIMIT_MS 1000
+#define ARENA_LINE_BUFFER 1024
+#define ARENA_Z_95 1.959963984540054
+
+// 자식 프로세스로 실행한 봇
+typedef struct {
+    pid_t pid;
+    FILE* in;                        // 봇의 stdin
+    int outFd;                       // 봇의 stdout (시간 제한 때문에 직접 read)
+    char buffer[ARENA_LINE_BUFFER];  // 아직 처리하지 않은 출력
+    int length;
+} ArenaBot;
+
+// 게임 한 판의 결과 (워커 → 집계 프로세스로 파이프 전송)
+typedef struct {
+    int game;
+    int winner;          // 0 = 봇A, 1 = 봇B, -1 = 무승부
+    int turns;
+    bool timedOut;       // 패배 원인이 응답 시간 초과/잘못된 출력인지
+    int responses[2];    // 봇별 응답 시간을 잰 턴 수 (시간 초과 턴 포함)
+    double totalMs[2];   // 봇별 응답 시간 합계
+    double maxMs[2];     // 봇별 최악 응답 시간
+    double wallMs;       // 게임 전체 소요 시간
+} ArenaResult;
+
+unsigned int arenaRng;
+
+// 심판용 난수 (봇의 nextRandom과 상태를 공유하지 않도록 별도 xorshift32)
+unsigned int arenaRandom(void) {
+    arenaRng ^= arenaRng << 13;
+    arenaRng ^= arenaRng >> 17;
+    arenaRng ^= arenaRng << 5;
+    return arenaRng;
+}
+
+// 봇 실행 파일을 파이프로 연결된 자식 프로세스로 시작 (recordPath가 있으면 그 경로를 BOT_RECORD로 넘김)
+ArenaBot spawnBot(const char* path, const char* recordPath) {
+    int toBot[2];
+    int fromBot[2];
+    ArenaBot bot;
+    memset(&bot, 0, sizeof(bot));
+    if (pipe(toBot) != 0 || pipe(fromBot) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(toBot[0], STDIN_FILENO);
+        dup2(fromBot[1], STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDERR_FILENO);
+        close(toBot[1]);
+        close(fromBot[0]);
+        if (recordPath != NULL) {
+            setenv("BOT_RECORD", recordPath, 1);
+        }
+        execl(path, path, (char*)NULL);
+        _exit(127);
+    }
+    close(toBot[0]);
+    close(fromBot[1]);
+    signal(SIGPIPE, SIG_IGN);
+    bot.pid = pid;
+    bot.in = fdopen(toBot[1], "w");
+    bot.outFd = fromBot[0];
+    return bot;
+}
+
+void killBot(ArenaBot* bot) {
+    kill(bot->pid, SIGKILL);
+    fclose(bot->in);
+    close(bot->outFd);
+    waitpid(bot->pid, NULL, 0);
+}
+
+// 시간 제한 안에 한 줄 읽기 (버퍼에 완성된 줄이 없으면 poll로 대기 후 read)
+bool readLineWithin(ArenaBot* bot, char* line, int size, double deadlineMs) {
+    while (1) {
+        char* newline = memchr(bot->buffer, '\n', bot->length);
+        if (newline != NULL) {
+            int lineLength = (int)(newline - bot->buffer);
+            int copy = lineLength < size - 1 ? lineLength : size - 1;
+            memcpy(line, bot->buffer, copy);
+            line[copy] = '\0';
+            bot->length -= lineLength + 1;
+            memmove(bot->buffer, newline + 1, bot->length);
+            return true;
+        }
+        if (bot->length == ARENA_LINE_BUFFER) {
+            return false;  // 개행 없이 너무 긴 출력
+        }
+        double remaining = deadlineMs - getTimeMs();
+        if (remaining <= 0) {
+            return false;
+        }
+        struct pollfd pfd = {bot->outFd, POLLIN, 0};
+        int ready = poll(&pfd, 1, (int)remaining + 1);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return false;
+        }
+        ssize_t n = read(bot->outFd, bot->buffer + bot->length, ARENA_LINE_BUFFER - bot->length);
+        if (n <= 0) {
+            return false;  // 봇 종료
+        }
+        bot->length += (int)n;
+    }
+}
+
+// 무작위 트랙 생성 (체크포인트끼리 최소 간격 유지)
+void generateTrack(SimTrack* track, unsigned int seed) {
+    arenaRng = seed * 2654435761u + 0x9e3779b9u;
+    if (arenaRng == 0) arenaRng = 1;
+    int count = ARENA_MIN_CHECKPOINTS + arenaRandom() % (ARENA_MAX_CHECKPOINTS - ARENA_MIN_CHECKPOINTS + 1);
+    for (int i = 0; i < count; i++) {
+        while (1) {
+            track->x[i] = CHECKPOINT_RADIUS + arenaRandom() % (ARENA_MAP_WIDTH - 2 * CHECKPOINT_RADIUS);
+            track->y[i] = CHECKPOINT_RADIUS + arenaRandom() % (ARENA_MAP_HEIGHT - 2 * CHECKPOINT_RADIUS);
+            bool spaced = true;
+            for (int j = 0; j < i; j++) {
+                if (hypot(track->x[i] - track->x[j], track->y[i] - track->y[j]) < ARENA_CHECKPOINT_GAP) {
+                    spaced = false;
+                }
+            }
+            if (spaced) break;
+        }
+    }
+    track->count = count;
+    track->totalCheckpoints = count * ARENA_LAPS;
+}
+
+// 출발 배치: 첫 체크포인트에서 두 번째 체크포인트 방향의 수직선 위에 ±500, ±1500 간격으로 정렬
+void placePods(SimState* sim, const SimTrack* track) {
+    static const double offsets[POD_COUNT] = {500, -500, 1500, -1500};
+    double dx = track->x[1] - track->x[0];
+    double dy = track->y[1] - track->y[0];
+    double len = sqrt(dx * dx + dy * dy);
+    memset(sim, 0, sizeof(*sim));
+    for (int i = 0; i < POD_COUNT; i++) {
+        sim->x[i] = floor(track->x[0] - dy / len * offsets[i] + 0.5);
+        sim->y[i] = floor(track->y[0] + dx / len * offsets[i] + 0.5);
+        sim->nextCheckpointId[i] = 1;
+    }
+    sim->timeout[0] = sim->timeout[1] = TIMEOUT_TURNS;
+    sim->boostAvailable[0] = sim->boostAvailable[1] = true;
+    sim->firstTurn = true;
+}
+
+// 봇의 출력 한 줄을 시뮬레이션 명령으로 변환 (형식이 잘못되면 false)
+bool parseMove(const SimState* sim, int pod, const char* line, SimMove* move) {
+    int x, y;
+    char word[32];
+    if (sscanf(line, "%d %d %31s", &x, &y, word) != 3) {
+        return false;
+    }
+    move->rotation[pod] = simDiffAngle(sim, pod, x, y);
+    if (strcmp(word, "SHIELD") == 0) {
+        move->thrust[pod] = THRUST_SHIELD;
+    } else if (strcmp(word, "BOOST") == 0) {
+        move->thrust[pod] = THRUST_BOOST;
+    } else {
+        char* end;
+        long thrust = strtol(word, &end, 10);
+        if (*end != '\0' || thrust < 0 || thrust > 100) {
+            return false;
+        }
+        move->thrust[pod] = (int)thrust;
+    }
+    return true;
+}
+
+// 게임 한 판 진행: side 0의 포드가 시뮬레이션 포드 0,1, side 1이 2,3
+ArenaResult playGame(const char* paths[2], int game, unsigned int seed) {
+    ArenaResult result;
+    memset(&result, 0, sizeof(result));
+    result.game = game;
+    result.winner = -1;
+    double gameStartMs = getTimeMs();
+
+    // 짝수/홀수 게임이 같은 트랙을 진영만 바꿔 사용
+    int swap = game & 1;
+    generateTrack(&simTrack, seed + game / 2);
+    SimState sim;
+    placePods(&sim, &simTrack);
+
+    // 두 봇이 같은 BOT_RECORD를 물려받아 한 파일에 겹쳐 쓰지 않도록 게임과 봇마다 경로를 나눔
+    const char* record = getenv("BOT_RECORD");
+    ArenaBot bots[2];
+    for (int side = 0; side < 2; side++) {
+        char recordPath[ARENA_LINE_BUFFER];
+        if (record != NULL) {
+            snprintf(recordPath, sizeof(recordPath), "%s.%d.%c", record, game, 'A' + (side ^ swap));
+        }
+        bots[side] = spawnBot(paths[side ^ swap], record != NULL ? recordPath : NULL);
+        fprintf(bots[side].in, "%d\n%d\n", ARENA_LAPS, simTrack.count);
+        for (int i = 0; i < simTrack.count; i++) {
+            fprintf(bots[side].in, "%d %d\n", (int)simTrack.x[i], (int)simTrack.y[i]);
+        }
+    }
+
+    int winnerSide = -1;
+    int turn;
+    for (turn = 0; turn < ARENA_MAX_TURNS && winnerSide < 0; turn++) {
+        SimMove move;
+        memset(&move, 0, sizeof(move));
+        double limitMs = turn == 0 ? ARENA_FIRST_TURN_LIMIT_MS : ARENA_TURN_LIMIT_MS;
+
+        for (int side = 0; side < 2 && winnerSide < 0; side++) {
+            // 자기 포드 2개 → 상대 포드 2개 순서로 전송
+            for (int k = 0; k < POD_COUNT; k++) {
+                int i = k < 2 ? side * 2 + k : (1 - side) * 2 + (k - 2);
+                int angle = turn == 0 ? -1 : (int)floor(sim.angle[i] + 0.5) % 360;
+                fprintf(bots[side].in, "%d %d %d %d %d %d\n", (int)sim.x[i], (int)sim.y[i],
+                        (int)sim.vx[i], (int)sim.vy[i], angle, sim.nextCheckpointId[i]);
+            }
+            fflush(bots[side].in);
+
+            double sentMs = getTimeMs();
+            for (int k = 0; k < 2; k++) {
+                char line[256];
+                if (!readLineWithin(&bots[side], line, sizeof(line), sentMs + limitMs) ||
+                    !parseMove(&sim, side * 2 + k, line, &move)) {
+                    winnerSide = 1 - side;
+                    result.timedOut = true;
+                    break;
+                }
+            }
+            double elapsedMs = getTimeMs() - sentMs;
+            int bot = side ^ swap;
+            result.responses[bot]++;
+            result.totalMs[bot] += elapsedMs;
+            if (elapsedMs > result.maxMs[bot]) {
+                result.maxMs[bot] = elapsedMs;
+            }
+        }
+        if (winnerSide >= 0) {
+            break;
+        }
+
+        simulateTurn(&sim, &move);
+        winnerSide = simWinner(&sim);
+    }
+
+    for (int side = 0; side < 2; side++) {
+        killBot(&bots[side]);
+    }
+    result.turns = turn;
+    result.winner = winnerSide < 0 ? -1 : winnerSide ^ swap;
+    result.wallMs = getTimeMs() - gameStartMs;
+    return result;
+}
+
+// 윌슨 점수 구간 (승률 p, 표본 n)
+void wilsonInterval(double p, int n, double* low, double* high) {
+    if (n == 0) {
+        *low = 0;
+        *high = 1;
+        return;
+    }
+    double z2 = ARENA_Z_95 * ARENA_Z_95;
+    double denom = 1 + z2 / n;
+    double center = (p + z2 / (2 * n)) / denom;
+    double margin = ARENA_Z_95 * sqrt(p * (1 - p) / n + z2 / (4.0 * n * n)) / denom;
+    *low = center - margin;
+    *high = center + margin;
+}
+
+// ARENA_NO_MAIN을 정의하고 포함하면 트랙 생성/배치 함수만 재사용 (MadPodRacingTuner.c)
+#ifndef ARENA_NO_MAIN
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <botA> <botB> [games] [workers] [seed]\n", argv[0]);
+        return 1;
+    }
+    const char* paths[2] = {argv[1], argv[2]};
+    int games = argc > 3 ? atoi(argv[3]) : 1000;
+    int workers = argc > 4 ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int seed = argc > 5 ? (unsigned int)strtoul(argv[5], NULL, 10) : 1;
+    if (workers < 1) workers = 1;
+    if (workers > games) workers = games;
+
+    // 워커마다 게임을 나눠 진행하고 결과를 파이프로 전송 (구조체 크기가 PIPE_BUF보다 작아 원자적 쓰기)
+    int results[2];
+    if (pipe(results) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    double startMs = getTimeMs();
+    for (int w = 0; w < workers; w++) {
+        if (fork() == 0) {
+            close(results[0]);
+            for (int g = w; g < games; g += workers) {
+                ArenaResult result = playGame(paths, g, seed);
+                if (write(results[1], &result, sizeof(result)) != sizeof(result)) {
+                    _exit(1);
+                }
+            }
+            _exit(0);
+        }
+    }
+    close(results[1]);
+
+    int wins[2] = {0, 0};
+    int draws = 0;
+    int timeouts[2] = {0, 0};
+    int done = 0;
+    long totalTurns = 0;
+    long responses[2] = {0, 0};
+    double totalMs[2] = {0, 0};
+    double maxMs[2] = {0, 0};
+    ArenaResult result;
+    while (read(results[0], &result, sizeof(result)) == sizeof(result)) {
+        done++;
+        totalTurns += result.turns;
+        if (result.winner < 0) {
+            draws++;
+        } else {
+            wins[result.winner]++;
+            if (result.timedOut) timeouts[1 - result.winner]++;
+        }
+        for (int b = 0; b < 2; b++) {
+            responses[b] += result.responses[b];
+            totalMs[b] += result.totalMs[b];
+            if (result.maxMs[b] > maxMs[b]) maxMs[b] = result.maxMs[b];
+        }
+        printf("game %4d: %-5s %3d turns, %6.0f ms wall, A avg %5.1f max %6.1f ms, B avg %5.1f max %6.1f ms\n",
+               result.game, result.winner < 0 ? "draw" : result.winner == 0 ? "A" : "B", result.turns,
+               result.wallMs, result.totalMs[0] / fmax(1, result.responses[0]), result.maxMs[0],
+               result.totalMs[1] / fmax(1, result.responses[1]), result.maxMs[1]);
+        fflush(stdout);
+    }
+    while (wait(NULL) > 0) {
+    }
+
+    // 무승부는 반승으로 계산
+    double score = done > 0 ? (wins[0] + 0.5 * draws) / done : 0;
+    double low, high;
+    wilsonInterval(score, done, &low, &high);
+    printf("\nA = %s, B = %s, %d games, %d workers, %.1f s\n", paths[0], paths[1], done, workers,
+           (getTimeMs() - startMs) / 1000.0);
+    printf("A wins %d, B wins %d, draws %d (timeouts: A %d, B %d)\n", wins[0], wins[1], draws, timeouts[0], timeouts[1]);
+    printf("A score %.1f%% (95%% CI %.1f%% ~ %.1f%%), average %.0f turns per game\n",
+           100 * score, 100 * low, 100 * high, done > 0 ? (double)totalTurns / done : 0);
+    printf("response time: A avg %.2f ms, max %.1f ms / B avg %.2f ms, max %.1f ms\n",
+           responses[0] > 0 ? totalMs[0] / responses[0] : 0, maxMs[0],
+           responses[1] > 0 ? totalMs[1] / responses[1] : 0, maxMs[1]);
+    return 0;
+}
+#endif
@@ -1,8 +1,20 @@
+// CodinGame은 최적화 옵션 없이 컴파일하므로 파일 안에서 지정
+#pragma GCC optimize("O3")
+
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define MAX_CHECKPOINTS 10
 #define CHECKPOINT_RADIUS 600
@@ -12,11 +24,66 @@
 #define DEG_TO_RAD(x) ((x) * PI / 180.0)
 #define RAD_TO_DEG(x) ((x) * 180.0 / PI)
 
+// 물리 엔진 상수 (심판 규칙과 동일)
+#define POD_COUNT 4
+#define MAX_ROTATION 18.0
+#define BOOST_THRUST 650
+#define SHIELD_MASS 10.0
+#define SHIELD_COOLDOWN 3
+#define MIN_IMPULSE 120.0
+#define TIMEOUT_TURNS 100
+#define THRUST_SHIELD -1
+#define THRUST_BOOST -2
+
+// 탐색 상수
+#define SEARCH_DEPTH 6
+#define POPULATION_SIZE 8
+#define SEARCH_TIME_MS 60.0
+#define FIRST_TURN_SEARCH_TIME_MS 800.0
+#define OPPONENT_SEARCH_SHARE 0.25
+#define RUNNER_SEARCH_SHARE 0.5        // 나머지 시간(1 - 상대 - 레이서)은 가로막기 탐색
+#define ROLE_SWITCH_TURNS 3.0          // 역할을 바꾸려면 다른 포드의 남은 턴이 이만큼 더 적어야 함
+#define PREDICTION_ERROR_DECAY 0.9
+#define BUDGET_POLL_INTERVAL 16
+#define INITIAL_ROLLOUT_RATE 200.0     // 첫 탐색의 예상 롤아웃 속도 (ms당), 이후 측정값 사용
+
+// 입출력 버퍼 크기 (입력은 한 턴 분량이 한 번의 read로 들어오도록 넉넉하게)
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define OUTPUT_BUFFER_SIZE (1 << 12)
+
+// 리플레이 로그 (환경 변수 BOT_RECORD로 경로 지정, MadPodRacingReplay.c로 재생)
+#define REPLAY_MAGIC 0x5252504Du       // "MPRR"
+#define REPLAY_VERSION 2
+#define REPLAY_INPUT 1                 // 표준 입력에서 읽은 원본 바이트
+#define REPLAY_TURN 2                  // 턴 결정 기록 (TurnRecord)
+
+// 레이싱 라인 캐시 상수
+#define SPEED_PROFILE_BINS 16
+#define SPEED_PROFILE_STEP 500
+#define LINE_CANDIDATE_ANGLES 24
+#define LINE_CANDIDATE_RADII 5
+#define LINE_ENTRY_SPEED 300.0
+#define LINE_MAX_TURNS 120
+
+// 쉴드 결정 상수
+#define SHIELD_LOOKAHEAD 3             // 쉴드 유무를 비교할 시뮬레이션 턴 수
+#define SHIELD_COAST_TURNS 3.0         // 시뮬레이션 끝 속도를 다음 체크포인트 방향으로 이만큼 더 이어서 평가
+
+// 부스트 계획 상수
+#define BOOST_BLOCKER_WEIGHT 0.5       // 가로막기 포드가 아낀 턴의 가치 (레이서 = 1)
+#define BOOST_WINDOW_SHARE 0.5         // 계획한 구간의 남은 턴이 계획 시점의 이 비율 아래로 떨어지면 사용하지 않음
+
 typedef struct {
     int x;
     int y;
 } Vector;
 
+// 실수 2D 벡터 (단위 벡터/방향 계산용, 정수 Vector의 절삭 오차 방지)
+typedef struct {
+    float x;
+    float y;
+} Vec2;
+
 typedef struct {
     Vector position;
     Vector velocity;
@@ -40,11 +107,39 @@ typedef struct {
 
 // 포드 정보 추가 구조체
 typedef struct {
-    float progress;    // 레이스 진행도
     Vector racingLine; // 최적 레이싱 라인 목표점
-    BezierCurve racingCurve; // 베지어 곡선 경로
 } PodInfo;
 
+// 체크포인트별 레이싱 라인 캐시 (이전 체크포인트 → 이 체크포인트 → 다음 체크포인트 구간 기준, 초기화 때 한 번 계산)
+typedef struct {
+    Vector entryPoint;       // 최적 진입 목표점
+    float exitAngle;         // 통과 후 향해야 할 각도 (도)
+    float turnAngle;         // 이 체크포인트에서 꺾이는 각도 (도, 0 ~ 180)
+    int segmentTurns;        // 이전 체크포인트에서 이 체크포인트까지 예상 소요 턴
+    float boostTurnsSaved;   // 이 구간에서 정렬되자마자 부스트를 쓰면 아끼는 턴
+    int speedProfile[SPEED_PROFILE_BINS]; // 체크포인트까지 거리 구간별 최적 라인 속도
+} RacingLineEntry;
+
+// 레이스 진행 추적 (포드 인덱스는 시뮬레이션과 같음: 0, 1 내 포드 / 2, 3 상대 포드)
+// 구간 시간 모델은 레이싱 라인 캐시의 구간 소요 턴으로 초기화 때 만들고, 조회는 O(1)
+typedef struct {
+    float segmentLength[MAX_CHECKPOINTS];               // 이전 체크포인트에서 이 체크포인트까지 거리
+    float segmentTurnsPrefix[2 * MAX_CHECKPOINTS + 1];  // 구간 소요 턴 누적합 (두 바퀴 분량)
+    float lapTurns;                                     // 한 바퀴 예상 턴
+    float distancePerTurn;                              // 한 바퀴 평균 턴당 이동 거리
+    int timeout[2];                                     // 팀별 남은 타임아웃 턴
+    float turnsToNext[POD_COUNT];                       // 다음 체크포인트까지 예상 턴
+    float turnsToFinish[POD_COUNT];                     // 완주까지 예상 턴
+} RaceProgress;
+
+// 레이스 전체 부스트 계획 (초기화 때와 내 포드가 체크포인트를 통과할 때마다 다시 계산)
+typedef struct {
+    int pod;                 // 부스트를 쓸 내 포드 (-1이면 계획 없음)
+    int checkpointId;        // 이 체크포인트로 향하는 구간에서 사용
+    float minTurnsToNext;    // 구간의 남은 예상 턴이 이보다 적으면 늦었으므로 사용하지 않음
+    float turnsSaved;        // 예상 절약 턴 (역할 가중치 적용)
+} BoostPlan;
+
 // 포드 명령어 구조체 추가
 typedef struct {
     Vector targetPos;
@@ -62,10 +157,12 @@ typedef struct {
     Pod myPods[2];
     Pod enemyPods[2];
     PodInfo myPodsInfo[2];
-    float enemyProgress[2];
+    RaceProgress race;
+    BoostPlan boostPlan;
     int totalCheckpoints;
     int longestStretch;
     bool firstTurn;
+    RacingLineEntry racingLine[MAX_CHECKPOINTS];
 } GameState;
 
 // PID 컨트롤러 구조체 추가
@@ -80,62 +177,353 @@ typedef struct {
     int minOutput;      // 최소 출력값 제한
 } PidController;
 
+// 시뮬레이션용 트랙 정보 (체크포인트 좌표를 double로 보관)
+typedef struct {
+    double x[MAX_CHECKPOINTS];
+    double y[MAX_CHECKPOINTS];
+    int count;
+    int totalCheckpoints;
+} SimTrack;
+
+// 시뮬레이션용 포드 상태 (SoA 배치: 0,1 = 내 포드, 2,3 = 적 포드)
+typedef struct {
+    double x[POD_COUNT];
+    double y[POD_COUNT];
+    double vx[POD_COUNT];
+    double vy[POD_COUNT];
+    double angle[POD_COUNT];          // 도(degree), 0 = 동쪽, 90 = 남쪽
+    int nextCheckpointId[POD_COUNT];
+    int checkpointsPassed[POD_COUNT];
+    int shieldCooldown[POD_COUNT];    // 가속할 수 없는 남은 턴 수
+    bool shieldActive[POD_COUNT];     // 이번 턴 쉴드 활성화 여부 (질량 10배)
+    int timeout[2];                   // 팀별 체크포인트 미통과 허용 남은 턴
+    bool boostAvailable[2];           // 팀별 부스트 (두 포드가 공유)
+    bool firstTurn;                   // 첫 턴에는 회전 제한 없음
+} SimState;
+
+// 시뮬레이션 한 턴의 명령
+typedef struct {
+    double rotation[POD_COUNT];  // 현재 각도 대비 회전량 (도), 엔진에서 ±18도로 제한
+    int thrust[POD_COUNT];       // 0~100 또는 THRUST_SHIELD, THRUST_BOOST
+} SimMove;
+
+// 롤링 호라이즌 유전자: 내 포드 2개의 SEARCH_DEPTH 턴 분량 명령
+typedef struct {
+    double rotation[2][SEARCH_DEPTH];
+    int thrust[2][SEARCH_DEPTH];   // 0~100 또는 THRUST_SHIELD, THRUST_BOOST
+    double score;
+} Genome;
+
+// 탐색 슬롯: 레이서(내 팀 전체 계획 보관), 상대 예측, 가로막기 (predictedPlan은 팀 번호를 슬롯으로 사용)
+#define SEARCH_RUNNER 0
+#define SEARCH_OPPONENT 1
+#define SEARCH_BLOCKER 2
+#define SEARCH_SLOTS 3
+
+// 턴 사이에 유지되는 탐색 상태 (슬롯별로 하나씩)
+typedef struct {
+    Genome population[POPULATION_SIZE];
+    Genome best;        // 이번 턴 최고 계획
+    bool initialized;
+    int rollouts;       // 이번 턴에 평가한 롤아웃 수
+    int rolloutQuota;   // 0보다 크면 시계 대신 이 롤아웃 수만큼 탐색 (리플레이 재현용)
+    float expectedRollouts;  // 변이 폭 스케줄 기준 (시간 예산 × 측정 속도)
+    double rolloutRate;      // 지난 탐색의 ms당 롤아웃 수
+} SearchState;
+
+// 턴마다 정하는 역할 (진행도 기준, 잦은 교체를 막기 위해 여유값 적용)
+typedef struct {
+    int runner;      // 레이스를 맡은 내 포드 (0 또는 1)
+    int blocker;     // 가로막기를 맡은 내 포드
+    int leader;      // 앞선 상대 포드 (시뮬레이션 인덱스 2 또는 3)
+    bool assigned;
+} RoleAssignment;
+
+// 상대 예측 모델: 탐색 계획과 기본 추적 중 최근 예측이 더 정확했던 쪽을 사용
+typedef struct {
+    double searchX[2], searchY[2];   // 지난 턴 탐색 계획으로 예측한 상대 위치
+    double chaseX[2], chaseY[2];     // 지난 턴 기본 추적으로 예측한 상대 위치
+    double searchError;              // 탐색 계획 예측 오차 (지수 이동 평균)
+    double chaseError;               // 기본 추적 예측 오차 (지수 이동 평균)
+    bool hasPrediction;
+} OpponentModel;
+
+// 턴 시간 예산 (첫 입력 바이트가 도착한 시점부터 단조 시계로 측정)
+typedef struct {
+    double startMs;      // 첫 입력 바이트 도착 시각
+    double parsedMs;     // 입력 파싱 완료 시각
+    double budgetMs;     // 이번 턴 사고 시간 예산 (startMs 기준)
+    double lastPollMs;   // 마지막으로 시계를 읽은 시각
+    double worstTurnMs;  // 지금까지 가장 오래 걸린 턴
+    int pollCounter;     // 시계 읽기 간격 조절용
+    int turn;
+} TurnBudget;
+
+// 표준 입력 버퍼 (read 한 번으로 도착한 만큼 채우고 정수는 직접 파싱)
+typedef struct {
+    int fd;
+    int length;
+    int position;
+    char data[INPUT_BUFFER_SIZE];
+} InputReader;
+
+// 표준 출력 버퍼 (한 턴의 명령을 모아 턴 끝에 write 한 번으로 내보냄)
+typedef struct {
+    int length;
+    char data[OUTPUT_BUFFER_SIZE];
+} OutputWriter;
+
+// 휴리스틱 파라미터 (MadPodRacingTuner.c로 조정한 값을 DEFAULT_BOT_PARAMS에 고정)
+typedef struct {
+    float pidKp;                // 충돌 회피 PID 비례 상수
+    float pidKi;                // 충돌 회피 PID 적분 상수
+    float pidKd;                // 충돌 회피 PID 미분 상수
+    float brakeMargin;          // 정지 거리 안전 마진
+    float brakeBase;            // 감속 기본 비율
+    float brakeSpeedWeight;     // 속도에 비례한 추가 감속 비율
+    float minThrustMultiplier;  // 감속할 때 최소 추력 비율
+    float corneringDecel;       // 코너링 감속 강도
+    float shieldMinGain;        // 쉴드 시뮬레이션 결과가 쉴드 없을 때보다 이만큼 나아야 사용
+} BotParams;
+
+// 파라미터 이름과 조정 범위 (문자열 로딩과 튜너에서 공용)
+typedef struct {
+    const char* name;
+    size_t offset;
+    float low;
+    float high;
+} BotParamInfo;
+
+// 리플레이 로그 헤더 (파일 맨 앞)
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    BotParams params;    // 기록할 때 사용한 휴리스틱 파라미터
+} ReplayHeader;
+
+// 리플레이 로그의 턴 기록: 탐색을 그대로 다시 돌리는 데 필요한 값과 실제로 내린 결정
+typedef struct {
+    unsigned int rngSeed;                   // 턴 시작 시 난수 상태
+    int rollouts[SEARCH_SLOTS];             // 슬롯별 롤아웃 수
+    float expectedRollouts[SEARCH_SLOTS];   // 슬롯별 변이 폭 스케줄 기준
+    float bestScore;
+    short targetX[2], targetY[2];
+    short thrust[2];                        // THRUST_SHIELD, THRUST_BOOST 포함
+} TurnRecord;
+
+#define BOT_PARAM_COUNT 9
+
+const BotParamInfo BOT_PARAM_INFO[BOT_PARAM_COUNT] = {
+    {"pidKp", offsetof(BotParams, pidKp), 0.0f, 2.0f},
+    {"pidKi", offsetof(BotParams, pidKi), 0.0f, 1.0f},
+    {"pidKd", offsetof(BotParams, pidKd), 0.0f, 1.0f},
+    {"brakeMargin", offsetof(BotParams, brakeMargin), 0.5f, 2.5f},
+    {"brakeBase", offsetof(BotParams, brakeBase), 0.0f, 1.0f},
+    {"brakeSpeedWeight", offsetof(BotParams, brakeSpeedWeight), 0.0f, 1.0f},
+    {"minThrustMultiplier", offsetof(BotParams, minThrustMultiplier), 0.0f, 1.0f},
+    {"corneringDecel", offsetof(BotParams, corneringDecel), 0.0f, 1.0f},
+    {"shieldMinGain", offsetof(BotParams, shieldMinGain), 0.0f, 1000.0f},
+};
+
+// 컴파일 시점에 고정된 파라미터 (튜너 출력으로 교체)
+const BotParams DEFAULT_BOT_PARAMS = {
+    .pidKp = 0.5f,
+    .pidKi = 0.1f,
+    .pidKd = 0.2f,
+    .brakeMargin = 1.2f,
+    .brakeBase = 0.6f,
+    .brakeSpeedWeight = 0.4f,
+    .minThrustMultiplier = 0.3f,
+    .corneringDecel = 0.6f,
+    .shieldMinGain = 200.0f,
+};
+
 // 전역 변수 대신 GameState 인스턴스 사용
 GameState gameState;
+SimTrack simTrack;
+SearchState searchState[SEARCH_SLOTS];
+RoleAssignment roles;
+OpponentModel opponentModel;
+TurnBudget turnBudget;
+BotParams botParams;
+PidController avoidancePid[2][2];   // 충돌 회피용 (내 포드 × 상대 포드)
+InputReader inputReader = {.fd = STDIN_FILENO};
+OutputWriter outputWriter;
+FILE* replayLog = NULL;
+unsigned int rngState = 2463534242u;
 
 // 함수 선언부
+float* botParamField(BotParams* params, int index);
+int loadBotParams(BotParams* params, const char* text);
 float distance(Vector a, Vector b);
+long long distanceSquared(Vector a, Vector b);
 float angleBetween(Vector a, Vector b);
-Vector normalize(Vector v);
+Vec2 toVec2(Vector v);
+Vec2 normalize(Vector v);
 Vector scale(Vector v, float scalar);
 Vector add(Vector a, Vector b);
 Vector subtract(Vector a, Vector b);
 float dotProduct(Vector a, Vector b);
+float dotProductVec2(Vec2 a, Vec2 b);
+double fastAtan2(double y, double x);
+void fastSinCos(double degrees, double* sinOut, double* cosOut);
 Vector closestPointToLine(Vector point, Vector lineStart, Vector lineEnd);
 bool willEnterCheckpointSoon(Pod pod, Checkpoint cp);
-bool isGoingToCollideWith(Pod pod1, Pod pod2);
 Vector predictCollisionWithPid(Pod pod, Pod other, PidController* pid, float deltaTime);
-float collisionNicenessScore(Pod pod, Pod other, Checkpoint target);
-bool shouldEnableShield(Pod pod, Pod myOtherPod, Pod enemies[], Checkpoint checkpoints[], int checkpointCount);
+bool shieldContactPossible(const SimState* sim);
+double shieldOutcome(const SimState* sim, int leader);
+void decideShields(GameState* state, PodCommand seeds[2], int leader);
 int calculateThrust(float angleDiff, int distToCheckpoint);
 
 // 베지어 곡선 관련 함수 선언 추가
 BezierCurve createBezierCurve(Vector p0, Vector p1, Vector p2, Vector p3);
 Vector evaluateBezierCurve(BezierCurve curve, float t);
-BezierCurve calculateRacingCurve(Pod pod, Checkpoint checkpoints[], int checkpointCount);
-Vector getBezierPoint(BezierCurve curve, float t);
-Vector getOptimalTargetFromCurve(Pod pod, BezierCurve curve, float lookAheadTime);
 
-Vector calculateRacingLine(Pod pod, Checkpoint checkpoints[], int checkpointCount, int lookAhead);
-float calculateProgress(Pod pod, Checkpoint checkpoints[], int checkpointCount);
-int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Checkpoint checkpoints[], int checkpointCount);
+Vector calculateRacingLine(Pod pod, GameState* state);
+int racingLineSpeed(GameState* state, int checkpointId, int distToCheckpoint);
+void precomputeSegmentModel(GameState* state);
+float estimateTurnsToFinish(const GameState* state, int nextCheckpointId, int checkpointsPassed, float distToNext);
+void updateRaceProgress(GameState* state);
+float podBoostSaving(GameState* state, int podIndex);
+void planBoost(GameState* state);
+bool boostPlanned(const GameState* state, int podIndex);
+bool boostOnPlan(const SimState* sim, const SimMove* move);
+int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, GameState* state);
 PidController initPidController(float kp, float ki, float kd, int minOutput, int maxOutput);
 float updatePidController(PidController* pid, float error, float deltaTime);
 void initializeGame(GameState* state);
 void updateGameState(GameState* state);
-PodCommand determinePodStrategy(Pod pod, Pod otherPod, Pod enemies[], GameState* state, int podIndex);
+PodCommand determinePodStrategy(Pod pod, GameState* state, int podIndex);
+PodCommand determineBlockerStrategy(Pod pod, Pod enemies[], int leader, GameState* state, int podIndex);
+void initAvoidancePid(void);
+void buildSeedCommands(GameState* state, RoleAssignment* roles, PidController pids[2][2], PodCommand seeds[2]);
+void playTurn(GameState* state, TurnRecord* record);
 void executePodCommand(PodCommand cmd);
 
+// 물리 엔진 함수 선언
+void initSimTrack(SimTrack* track, GameState* state);
+void loadSimState(SimState* sim, GameState* state);
+double simContactTime(double dx, double dy, double dvx, double dvy, double radius, double maxTime, bool solid);
+double simDiffAngle(const SimState* sim, int pod, double targetX, double targetY);
+Vector simTargetPoint(const SimState* sim, int pod, double rotation);
+void simApplyMove(SimState* sim, const SimMove* move);
+void simBounce(SimState* sim, int a, int b);
+void simPassCheckpoint(SimState* sim, int pod);
+void simMovePods(SimState* sim);
+void simEndTurn(SimState* sim);
+void simulateTurn(SimState* sim, const SimMove* move);
+int simWinner(const SimState* sim);
+
+// 레이싱 라인 캐시 함수 선언
+double simulateRacingLine(GameState* state, int checkpointId, Vector entry, bool boost, RacingLineEntry* out);
+double driveRacingLine(GameState* state, SimState* sim, int checkpointId, Vector entry, bool boost, RacingLineEntry* out);
+void precomputeRacingLine(GameState* state);
+
+// 시간 예산 함수 선언
+double getTimeMs(void);
+bool beginTurnBudget(TurnBudget* budget, double budgetMs);
+void markInputParsed(TurnBudget* budget);
+double budgetDeadline(const TurnBudget* budget, double share);
+bool budgetExpired(TurnBudget* budget, double deadlineMs);
+void endTurnBudget(TurnBudget* budget, int rollouts);
+
+// 입출력 버퍼 함수 선언
+bool fillInput(InputReader* reader);
+int peekInput(InputReader* reader);
+void skipWhitespace(InputReader* reader);
+bool readInt(InputReader* reader, int* value);
+void flushOutput(OutputWriter* writer);
+void writeChar(OutputWriter* writer, char c);
+void writeString(OutputWriter* writer, const char* text);
+void writeInt(OutputWriter* writer, int value);
+
+// 리플레이 기록 함수 선언
+void writeReplayRecord(int type, const void* data, unsigned int size);
+bool startRecording(const char* path);
+
+// 탐색 함수 선언
+unsigned int nextRandom(void);
+double randomRange(double low, double high);
+void defaultTeamMove(const SimState* sim, SimMove* move, int team);
+void applyGenomeTurn(const SimState* sim, SimMove* move, int team, const Genome* genome, int turn);
+double podProgress(const SimState* sim, int pod);
+void assignRoles(RoleAssignment* roles, const RaceProgress* race);
+double evaluateSimState(const SimState* sim, int team);
+double evaluateRunner(const SimState* sim);
+double evaluateBlocker(const SimState* sim, double interceptDistance);
+double evaluateGenome(const SimState* start, Genome* genome, int slot, const Genome* opponent);
+void seedGenome(Genome* genome, const SimState* start, int team, PodCommand seeds[2], const Genome* opponent);
+void mutateGenome(Genome* child, const Genome* parent, const SimState* start, int team, int mutablePod, double amplitude);
+void shiftGenome(Genome* genome);
+void copyPodGenes(Genome* genome, const Genome* source, int pod);
+void predictedPlan(Genome* plan, const SimState* start, int team, PodCommand seeds[2]);
+Genome* runSearch(const SimState* start, int slot, PodCommand seeds[2], const Genome* fixedPlan, int mutablePod,
+                  const Genome* opponent, TurnBudget* budget, double deadlineMs);
+PodCommand genomeToCommand(const Genome* genome, const SimState* start, int pod);
+void updateOpponentModel(OpponentModel* model, const SimState* sim);
+const Genome* chooseOpponentPlan(const OpponentModel* model, const Genome* searchPlan);
+void recordOpponentPrediction(OpponentModel* model, const SimState* sim, const Genome* myPlan, const Genome* searchPlan);
+
+// 파라미터 index번째 값의 주소
+float* botParamField(BotParams* params, int index) {
+    return (float*)((char*)params + BOT_PARAM_INFO[index].offset);
+}
+
+// "이름=값" 목록(쉼표/공백 구분)으로 파라미터 덮어쓰기, 적용한 개수 반환
+int loadBotParams(BotParams* params, const char* text) {
+    int loaded = 0;
+    while (text != NULL && *text != '\0') {
+        char name[64];
+        float value;
+        int consumed = 0;
+        if (sscanf(text, " %63[^=, ]=%f%n", name, &value, &consumed) != 2) {
+            break;
+        }
+        text += consumed;
+        while (*text == ',' || *text == ' ') text++;
+
+        int index = 0;
+        while (index < BOT_PARAM_COUNT && strcmp(BOT_PARAM_INFO[index].name, name) != 0) index++;
+        if (index == BOT_PARAM_COUNT) {
+            fprintf(stderr, "Unknown parameter %s\n", name);
+            continue;
+        }
+        *botParamField(params, index) = value;
+        loaded++;
+    }
+    return loaded;
+}
+
 // 거리 계산 함수
 float distance(Vector a, Vector b) {
-    return sqrtf((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+    return sqrtf((float)distanceSquared(a, b));
+}
+
+// 거리 제곱 (비교만 필요할 때 sqrt 생략, 트랙 밖 좌표에서도 넘치지 않도록 64비트)
+long long distanceSquared(Vector a, Vector b) {
+    long long dx = a.x - b.x;
+    long long dy = a.y - b.y;
+    return dx * dx + dy * dy;
 }
 
 // 두 벡터 사이의 각도 계산 (라디안)
 float angleBetween(Vector a, Vector b) {
-    return atan2f(b.y - a.y, b.x - a.x);
+    return (float)fastAtan2(b.y - a.y, b.x - a.x);
 }
 
-// 벡터 정규화
-Vector normalize(Vector v) {
-    float len = sqrtf(v.x * v.x + v.y * v.y);
-    Vector result;
+// 정수 벡터를 실수 벡터로 변환
+Vec2 toVec2(Vector v) {
+    Vec2 result = {(float)v.x, (float)v.y};
+    return result;
+}
+
+// 벡터 정규화 (실수 단위 벡터 반환, 길이가 0이면 영벡터)
+Vec2 normalize(Vector v) {
+    float len = sqrtf((float)v.x * v.x + (float)v.y * v.y);
+    Vec2 result = {0.0f, 0.0f};
     if (len > 0) {
         result.x = v.x / len;
         result.y = v.y / len;
-    } else {
-        result.x = 0;
-        result.y = 0;
     }
     return result;
 }
@@ -166,29 +554,66 @@ Vector subtract(Vector a, Vector b) {
 
 // 내적
 float dotProduct(Vector a, Vector b) {
+    return (float)a.x * b.x + (float)a.y * b.y;
+}
+
+// 실수 벡터 내적
+float dotProductVec2(Vec2 a, Vec2 b) {
     return a.x * b.x + a.y * b.y;
 }
 
+// 빠른 atan2 근사 (다항식, 최대 오차 약 2e-6 라디안)
+double fastAtan2(double y, double x) {
+    double ax = fabs(x);
+    double ay = fabs(y);
+    if (ax == 0 && ay == 0) {
+        return 0.0;
+    }
+    double z = ax > ay ? ay / ax : ax / ay;
+    double zz = z * z;
+    double a = z * (0.99997726 + zz * (-0.33262347 + zz * (0.19354346 +
+               zz * (-0.11643287 + zz * (0.05265332 + zz * -0.01172120)))));
+    if (ay > ax) a = PI / 2 - a;
+    if (x < 0) a = PI - a;
+    return y < 0 ? -a : a;
+}
+
+// 빠른 sin/cos (도 단위 입력, 90도 단위로 축소 후 테일러 전개, 오차 1e-8 이하)
+void fastSinCos(double degrees, double* sinOut, double* cosOut) {
+    double turns = degrees / 90.0;
+    int quadrant = (int)(turns >= 0 ? turns + 0.5 : turns - 0.5);
+    double r = DEG_TO_RAD(degrees - 90.0 * quadrant);
+    double rr = r * r;
+    double s = r * (1.0 + rr * (-1.0 / 6 + rr * (1.0 / 120 + rr * (-1.0 / 5040 +
+               rr * (1.0 / 362880 + rr * (-1.0 / 39916800))))));
+    double c = 1.0 + rr * (-0.5 + rr * (1.0 / 24 + rr * (-1.0 / 720 +
+               rr * (1.0 / 40320 + rr * (-1.0 / 3628800)))));
+    switch (quadrant & 3) {
+        case 0: *sinOut = s;  *cosOut = c;  break;
+        case 1: *sinOut = c;  *cosOut = -s; break;
+        case 2: *sinOut = -s; *cosOut = -c; break;
+        default: *sinOut = -c; *cosOut = s; break;
+    }
+}
+
 // 점과 직선 사이의 가장 가까운 점을 찾음
 Vector closestPointToLine(Vector point, Vector lineStart, Vector lineEnd) {
     Vector line = subtract(lineEnd, lineStart);
-    float len = sqrtf(line.x * line.x + line.y * line.y);
-    line = normalize(line);
-    Vector v = subtract(point, lineStart);
-    float d = dotProduct(v, line);
+    float len = sqrtf((float)distanceSquared(lineEnd, lineStart));
+    Vec2 dir = normalize(line);
+    float d = dotProductVec2(toVec2(subtract(point, lineStart)), dir);
     d = fmaxf(0, fminf(len, d));
     Vector result;
-    result.x = lineStart.x + (int)(line.x * d);
-    result.y = lineStart.y + (int)(line.y * d);
+    result.x = lineStart.x + (int)(dir.x * d);
+    result.y = lineStart.y + (int)(dir.y * d);
     return result;
 }
 
 // 곧 체크포인트에 들어갈지 예측
 bool willEnterCheckpointSoon(Pod pod, Checkpoint cp) {
-    Vector futurePos;
-    futurePos.x = pod.position.x + pod.velocity.x;
-    futurePos.y = pod.position.y + pod.velocity.y;
-    return distance(futurePos, cp.position) < CHECKPOINT_RADIUS;
+    // 이번 턴 이동 경로 중 한 번이라도 반경 안에 들어오면 통과 (연속 시간 판정)
+    return simContactTime(pod.position.x - cp.position.x, pod.position.y - cp.position.y,
+                          pod.velocity.x, pod.velocity.y, CHECKPOINT_RADIUS, 1.0, false) >= 0;
 }
 
 // PID 컨트롤러 초기화 함수
@@ -228,18 +653,6 @@ float updatePidController(PidController* pid, float error, float deltaTime) {
     return pid->output;
 }
 
-// 개선된 충돌 예측 함수 (PID 컨트롤러 사용)
-bool isGoingToCollideWith(Pod pod1, Pod pod2) {
-    // 기본 충돌 감지 (현재 코드 유지)
-    Vector futurePos1, futurePos2;
-    futurePos1.x = pod1.position.x + pod1.velocity.x;
-    futurePos1.y = pod1.position.y + pod1.velocity.y;
-    futurePos2.x = pod2.position.x + pod2.velocity.x;
-    futurePos2.y = pod2.position.y + pod2.velocity.y;
-    
-    return distance(futurePos1, futurePos2) < 2 * POD_RADIUS;
-}
-
 // PID 기반 충돌 예측 및 회피 함수
 Vector predictCollisionWithPid(Pod pod, Pod other, PidController* pid, float deltaTime) {
     // 현재 거리 계산
@@ -257,24 +670,27 @@ Vector predictCollisionWithPid(Pod pod, Pod other, PidController* pid, float del
     float collisionDist = 0;
     
     for (int step = 1; step <= 8; step++) {
-        // 속도 적용 및 마찰 계산
+        // 턴 도중의 접촉까지 연속 시간으로 감지
+        double contact = simContactTime(podFuturePos.x - otherFuturePos.x, podFuturePos.y - otherFuturePos.y,
+                                        podFutureVel.x - otherFutureVel.x, podFutureVel.y - otherFutureVel.y,
+                                        2 * POD_RADIUS, 1.0, true);
+        
+        // 속도 적용 및 마찰 계산 (심판과 같이 속도는 절삭)
         podFuturePos.x += podFutureVel.x;
         podFuturePos.y += podFutureVel.y;
-        podFutureVel.x *= FRICTION;
-        podFutureVel.y *= FRICTION;
+        podFutureVel.x = (int)(podFutureVel.x * FRICTION);
+        podFutureVel.y = (int)(podFutureVel.y * FRICTION);
         
         otherFuturePos.x += otherFutureVel.x;
         otherFuturePos.y += otherFutureVel.y;
-        otherFutureVel.x *= FRICTION;
-        otherFutureVel.y *= FRICTION;
-        
-        float futureDist = distance(podFuturePos, otherFuturePos);
+        otherFutureVel.x = (int)(otherFutureVel.x * FRICTION);
+        otherFutureVel.y = (int)(otherFutureVel.y * FRICTION);
         
         // 충돌 감지
-        if (futureDist < 2 * POD_RADIUS) {
+        if (contact >= 0) {
             willCollide = true;
             collisionStep = step;
-            collisionDist = futureDist;
+            collisionDist = distance(podFuturePos, otherFuturePos);
             break;
         }
     }
@@ -291,8 +707,7 @@ Vector predictCollisionWithPid(Pod pod, Pod other, PidController* pid, float del
         float avoidanceStrength = updatePidController(pid, error, deltaTime);
         
         // 회피 방향 계산 (다른 포드로부터 멀어지는 방향)
-        Vector avoidDir = subtract(pod.position, other.position);
-        avoidDir = normalize(avoidDir);
+        Vec2 avoidDir = normalize(subtract(pod.position, other.position));
         
         // 회피 벡터 계산
         avoidanceVector.x = (int)(avoidDir.x * avoidanceStrength);
@@ -307,55 +722,102 @@ Vector predictCollisionWithPid(Pod pod, Pod other, PidController* pid, float del
     return avoidanceVector;
 }
 
-// 충돌이 얼마나 유리한지 점수 계산
-float collisionNicenessScore(Pod pod, Pod other, Checkpoint target) {
-    if (!isGoingToCollideWith(pod, other)) {
-        return 0;
+// 쉴드 비교 시뮬레이션 동안 어떤 두 포드라도 닿을 수 있는지 (최대 가속 포함, 아니면 쉴드 계산 생략)
+bool shieldContactPossible(const SimState* sim) {
+    for (int i = 0; i < POD_COUNT; i++) {
+        for (int j = i + 1; j < POD_COUNT; j++) {
+            double reach = 2 * POD_RADIUS + (hypot(sim->vx[i], sim->vy[i]) + hypot(sim->vx[j], sim->vy[j]) + 2 * BOOST_THRUST) * SHIELD_LOOKAHEAD;
+            double dx = sim->x[i] - sim->x[j];
+            double dy = sim->y[i] - sim->y[j];
+            if (dx * dx + dy * dy < reach * reach) {
+                return true;
+            }
+        }
     }
-    
-    float baseDistance = distance(pod.position, target.position);
-    
-    Vector futureVel;
-    futureVel.x = (int)((pod.velocity.x * FRICTION) + (other.velocity.x * FRICTION * 0.5));
-    futureVel.y = (int)((pod.velocity.y * FRICTION) + (other.velocity.y * FRICTION * 0.5));
-    
-    Vector futurePos;
-    futurePos.x = pod.position.x + futureVel.x;
-    futurePos.y = pod.position.y + futureVel.y;
-    
-    float newDistance = distance(futurePos, target.position);
-    
-    // 충돌 후 더 가까워지면 양수, 멀어지면 음수
-    return baseDistance - newDistance;
+    return false;
 }
 
-// 쉴드 사용 여부 결정 함수 (수정: 체크포인트 배열 매개변수 추가)
-bool shouldEnableShield(Pod pod, Pod myOtherPod, Pod enemies[], Checkpoint checkpoints[], int checkpointCount) {
-    // 쉴드 쿨다운 중이면 사용 불가
-    if (pod.shieldCooldown > 0) {
-        return false;
-    }
+// 쉴드 비교 시뮬레이션 결과 점수: 내 두 포드의 진행 - 앞선 상대 포드의 진행
+// (짧은 시뮬레이션이라 끝 속도를 다음 체크포인트 방향으로 조금 더 이어서 쉴드 후 감속 손해를 반영)
+double shieldOutcome(const SimState* sim, int leader) {
+    int winner = simWinner(sim);
+    if (winner == 0) return 1e9;
+    if (winner >= 0) return -1e9;
     
-    Checkpoint target = checkpoints[pod.nextCheckpointId];
+    double value = 0;
+    for (int i = 0; i < POD_COUNT; i++) {
+        if (i >= 2 && i != leader) {
+            continue;
+        }
+        int cp = sim->nextCheckpointId[i];
+        double dx = simTrack.x[cp] - sim->x[i];
+        double dy = simTrack.y[cp] - sim->y[i];
+        double dist = sqrt(dx * dx + dy * dy);
+        double coast = dist > 0 ? (sim->vx[i] * dx + sim->vy[i] * dy) / dist * SHIELD_COAST_TURNS : 0;
+        double progress = podProgress(sim, i) + coast;
+        value += i < 2 ? progress : -progress;
+    }
+    return value;
+}
+
+// 쉴드 결정: 쉴드를 쓸 수 있는 내 포드 조합마다(쉴드 없음 포함) 네 포드를 모두 넣은 SHIELD_LOOKAHEAD 턴
+// 시뮬레이션을 한 번에 돌려(10배 질량과 쿨다운은 물리 엔진이 처리) 팀 진행이 가장 좋은 조합 선택
+// 첫 턴 내 포드는 seeds 명령, 이후와 상대 포드는 기본 추적으로 이동
+void decideShields(GameState* state, PodCommand seeds[2], int leader) {
+    seeds[0].useShield = false;
+    seeds[1].useShield = false;
     
-    // 내 다른 포드와의 충돌이 있을 경우
-    float allyScore = collisionNicenessScore(pod, myOtherPod, target);
-    if (allyScore < -200) { // 불리한 충돌이면 쉴드 사용
-        return true;
+    SimState base;
+    loadSimState(&base, state);
+    if (!shieldContactPossible(&base)) {
+        return;
     }
     
-    // 적 포드와의 충돌이 있을 경우
-    for (int i = 0; i < 2; i++) {
-        float enemyScore = collisionNicenessScore(pod, enemies[i], target);
-        if (enemyScore > 200) { // 유리한 충돌이면 쉴드 사용
-            return true;
+    // 후보 조합 (비트 k = 내 포드 k 쉴드, 0번 후보는 쉴드 없음)
+    int masks[4];
+    int candidates = 0;
+    for (int mask = 0; mask < 4; mask++) {
+        if (((mask & 1) && base.shieldCooldown[0] > 0) || ((mask & 2) && base.shieldCooldown[1] > 0)) {
+            continue;
         }
-        if (enemyScore < -300) { // 매우 불리한 충돌이면 쉴드 사용
-            return true;
+        masks[candidates++] = mask;
+    }
+    
+    SimState sims[4];
+    for (int c = 0; c < candidates; c++) {
+        sims[c] = base;
+    }
+    SimMove move;
+    for (int turn = 0; turn < SHIELD_LOOKAHEAD; turn++) {
+        for (int c = 0; c < candidates; c++) {
+            SimState* sim = &sims[c];
+            if (simWinner(sim) >= 0) {
+                continue;
+            }
+            defaultTeamMove(sim, &move, 0);
+            defaultTeamMove(sim, &move, 1);
+            if (turn == 0) {
+                for (int k = 0; k < 2; k++) {
+                    move.rotation[k] = simDiffAngle(sim, k, seeds[k].targetPos.x, seeds[k].targetPos.y);
+                    move.thrust[k] = (masks[c] >> k) & 1 ? THRUST_SHIELD : seeds[k].useBoost ? THRUST_BOOST : seeds[k].thrust;
+                }
+            }
+            simulateTurn(sim, &move);
         }
     }
     
-    return false;
+    double baseline = shieldOutcome(&sims[0], leader);
+    int best = 0;
+    double bestScore = baseline + botParams.shieldMinGain;
+    for (int c = 1; c < candidates; c++) {
+        double score = shieldOutcome(&sims[c], leader);
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+    }
+    seeds[0].useShield = masks[best] & 1;
+    seeds[1].useShield = (masks[best] >> 1) & 1;
 }
 
 // 추력(thrust) 계산
@@ -407,35 +869,143 @@ Vector evaluateBezierCurve(BezierCurve curve, float t) {
     return result;
 }
 
-// 베지어 곡선 기반 레이싱 경로 계산
-BezierCurve calculateRacingCurve(Pod pod, Checkpoint checkpoints[], int checkpointCount) {
-    Vector p0 = pod.position;
-    Vector p1 = checkpoints[pod.nextCheckpointId].position;
-    Vector p2 = checkpoints[(pod.nextCheckpointId + 1) % checkpointCount].position;
-    Vector p3 = checkpoints[(pod.nextCheckpointId + 2) % checkpointCount].position;
-    return createBezierCurve(p0, p1, p2, p3);
+// 레이싱 라인 계산 함수 (초기화 때 계산한 캐시에서 O(1) 조회)
+Vector calculateRacingLine(Pod pod, GameState* state) {
+    return state->racingLine[pod.nextCheckpointId].entryPoint;
+}
+
+// 체크포인트까지 거리에 해당하는 최적 라인 속도 조회
+int racingLineSpeed(GameState* state, int checkpointId, int distToCheckpoint) {
+    int bin = distToCheckpoint / SPEED_PROFILE_STEP;
+    if (bin >= SPEED_PROFILE_BINS) bin = SPEED_PROFILE_BINS - 1;
+    if (bin < 0) bin = 0;
+    return state->racingLine[checkpointId].speedProfile[bin];
+}
+
+// 구간 시간 모델 생성: 레이싱 라인 캐시의 구간 소요 턴을 두 바퀴 분량 누적합으로 저장
+void precomputeSegmentModel(GameState* state) {
+    RaceProgress* race = &state->race;
+    int count = state->checkpointCount;
+    float lapLength = 0;
+    for (int i = 0; i < count; i++) {
+        race->segmentLength[i] = fmaxf(1.0f, distance(state->checkpoints[(i + count - 1) % count].position,
+                                                      state->checkpoints[i].position));
+        lapLength += race->segmentLength[i];
+    }
+    race->segmentTurnsPrefix[0] = 0;
+    for (int k = 1; k <= 2 * count; k++) {
+        race->segmentTurnsPrefix[k] = race->segmentTurnsPrefix[k - 1] + state->racingLine[k % count].segmentTurns;
+    }
+    race->lapTurns = race->segmentTurnsPrefix[count];
+    race->distancePerTurn = lapLength / fmaxf(1.0f, race->lapTurns);
+    race->timeout[0] = TIMEOUT_TURNS;
+    race->timeout[1] = TIMEOUT_TURNS;
+}
+
+// 완주까지 예상 턴: 다음 체크포인트까지는 구간 안 남은 거리 비율, 그 뒤는 남은 구간 소요 턴의 합
+float estimateTurnsToFinish(const GameState* state, int nextCheckpointId, int checkpointsPassed, float distToNext) {
+    const RaceProgress* race = &state->race;
+    int remaining = state->totalCheckpoints - checkpointsPassed - 1;
+    if (remaining < 0) {
+        return 0;
+    }
+    float toNext = distToNext / race->segmentLength[nextCheckpointId] * state->racingLine[nextCheckpointId].segmentTurns;
+    int laps = remaining / state->checkpointCount;
+    int rest = remaining % state->checkpointCount;
+    return toNext + laps * race->lapTurns
+         + race->segmentTurnsPrefix[nextCheckpointId + rest] - race->segmentTurnsPrefix[nextCheckpointId];
+}
+
+// 네 포드의 다음 체크포인트까지, 완주까지 예상 턴 갱신 (체크포인트 통과 수는 updateGameState에서 추적)
+void updateRaceProgress(GameState* state) {
+    RaceProgress* race = &state->race;
+    for (int i = 0; i < POD_COUNT; i++) {
+        const Pod* pod = i < 2 ? &state->myPods[i] : &state->enemyPods[i - 2];
+        int cp = pod->nextCheckpointId;
+        float dist = distance(pod->position, state->checkpoints[cp].position);
+        race->turnsToNext[i] = dist / race->segmentLength[cp] * state->racingLine[cp].segmentTurns;
+        race->turnsToFinish[i] = estimateTurnsToFinish(state, cp, pod->checkpointsPassed, dist);
+    }
+}
+
+// 내 포드가 지금 위치와 속도에서 현재 구간에 부스트를 쓰면 아끼는 턴 (다른 포드 없이 레이싱 라인 주행)
+// 어느 한쪽 주행이라도 체크포인트에 닿지 못하면 추정할 수 없으므로 캐시한 구간 값을 사용
+float podBoostSaving(GameState* state, int podIndex) {
+    const Pod* pod = &state->myPods[podIndex];
+    SimState sim;
+    memset(&sim, 0, sizeof(sim));
+    for (int i = 1; i < POD_COUNT; i++) {
+        sim.x[i] = -1000000.0 * i;
+        sim.y[i] = -1000000.0;
+    }
+    sim.x[0] = pod->position.x;
+    sim.y[0] = pod->position.y;
+    sim.vx[0] = pod->velocity.x;
+    sim.vy[0] = pod->velocity.y;
+    sim.angle[0] = pod->angle;
+    sim.firstTurn = state->firstTurn;
+    sim.nextCheckpointId[0] = pod->nextCheckpointId;
+    sim.timeout[0] = sim.timeout[1] = LINE_MAX_TURNS + 1;
+
+    Vector entry = state->racingLine[pod->nextCheckpointId].entryPoint;
+    double plain = driveRacingLine(state, &sim, pod->nextCheckpointId, entry, false, NULL);
+    double boosted = driveRacingLine(state, &sim, pod->nextCheckpointId, entry, true, NULL);
+    if (plain > LINE_MAX_TURNS || boosted > LINE_MAX_TURNS) {
+        return state->racingLine[pod->nextCheckpointId].boostTurnsSaved;
+    }
+    return (float)fmax(0.0, plain - boosted);
 }
 
-// 베지어 곡선에서 최적 목표 지점 계산
-Vector getOptimalTargetFromCurve(Pod pod, BezierCurve curve, float lookAheadTime) {
-    return evaluateBezierCurve(curve, lookAheadTime);
+// 부스트 계획: 두 포드 각각 남은 레이스의 모든 구간(현재 구간은 실제 상태로 시뮬레이션, 이후 구간은 캐시)을
+// 후보로 보고, 역할 가중치를 곱한 절약 턴이 가장 큰 (포드, 구간) 선택 (같으면 먼저 오는 구간)
+void planBoost(GameState* state) {
+    BoostPlan* plan = &state->boostPlan;
+    plan->pod = -1;
+    plan->turnsSaved = 0;
+    if (!state->myPods[0].boostAvailable || !state->myPods[1].boostAvailable) {
+        return;
+    }
+
+    const RaceProgress* race = &state->race;
+    int count = state->checkpointCount;
+    int runner = race->turnsToFinish[0] <= race->turnsToFinish[1] ? 0 : 1;
+    for (int p = 0; p < 2; p++) {
+        const Pod* pod = &state->myPods[p];
+        float weight = p == runner ? 1.0f : BOOST_BLOCKER_WEIGHT;
+        int segments = state->totalCheckpoints - pod->checkpointsPassed;
+        if (segments > count) segments = count;
+
+        for (int k = 0; k < segments; k++) {
+            int cp = (pod->nextCheckpointId + k) % count;
+            float saved = weight * (k == 0 ? podBoostSaving(state, p) : state->racingLine[cp].boostTurnsSaved);
+            if (saved > plan->turnsSaved) {
+                plan->pod = p;
+                plan->checkpointId = cp;
+                plan->turnsSaved = saved;
+                plan->minTurnsToNext = BOOST_WINDOW_SHARE * (k == 0 ? race->turnsToNext[p] : state->racingLine[cp].segmentTurns);
+            }
+        }
+    }
 }
 
-// 레이싱 라인 계산 함수 (수정: 베지어 곡선 기반으로 변경)
-Vector calculateRacingLine(Pod pod, Checkpoint checkpoints[], int checkpointCount, int lookAhead) {
-    BezierCurve curve = calculateRacingCurve(pod, checkpoints, checkpointCount);
-    return getOptimalTargetFromCurve(pod, curve, 0.5f); // lookAheadTime은 0.5로 설정
+// 이번 턴 이 포드가 계획한 구간 안에 있고 아직 늦지 않았는지
+bool boostPlanned(const GameState* state, int podIndex) {
+    const BoostPlan* plan = &state->boostPlan;
+    return plan->pod == podIndex
+        && state->myPods[podIndex].nextCheckpointId == plan->checkpointId
+        && state->race.turnsToNext[podIndex] >= plan->minTurnsToNext;
 }
 
-// 포드 진행상황 계산 (수정: 체크포인트 배열 매개변수 추가)
-float calculateProgress(Pod pod, Checkpoint checkpoints[], int checkpointCount) {
-    return pod.checkpointsPassed + 
-           (1.0f - fminf(1.0f, distance(pod.position, checkpoints[pod.nextCheckpointId].position) / 
-           (2 * CHECKPOINT_RADIUS))) / checkpointCount;
+// 시뮬레이션에서 이번 턴 부스트가 계획한 포드와 구간에서 쓰였는지 (move 적용 전 상태 기준)
+bool boostOnPlan(const SimState* sim, const SimMove* move) {
+    const BoostPlan* plan = &gameState.boostPlan;
+    return plan->pod >= 0
+        && move->thrust[plan->pod] == THRUST_BOOST
+        && sim->nextCheckpointId[plan->pod] == plan->checkpointId;
 }
 
 // 속도 기반 추력 계산 함수 (수정: 더 정밀한 계산 적용)
-int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Checkpoint checkpoints[], int checkpointCount) {
+int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, GameState* state) {
     // 각도가 매우 큰 경우 점진적으로 추력 감소
     if (angleDiff > 90) {
         // 90도 초과 시 부드러운 감소 (180도에 가까울수록 더 낮아짐)
@@ -449,18 +1019,17 @@ int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Chec
     float currentSpeed = sqrtf(pod.velocity.x * pod.velocity.x + pod.velocity.y * pod.velocity.y);
     
     // 목표 지점 방향의 단위 벡터 계산
-    Vector targetPos = checkpoints[pod.nextCheckpointId].position;
+    Vector targetPos = state->checkpoints[pod.nextCheckpointId].position;
     Vector dirVector = subtract(targetPos, pod.position);
-    float dirLength = sqrtf(dirVector.x * dirVector.x + dirVector.y * dirVector.y);
-    
-    Vector targetDir = normalize(dirVector);
-    Vector velocityDir = normalize(pod.velocity);
+    Vec2 targetDir = normalize(dirVector);
+    Vec2 velocityDir = normalize(pod.velocity);
     
     // 속도 벡터와 목표 방향 벡터의 내적 (방향 일치도, -1.0 ~ 1.0)
-    float directionAlignment = dotProduct(velocityDir, targetDir);
+    float directionAlignment = dotProductVec2(velocityDir, targetDir);
     
-    // 체크포인트에 가까워지면 적응형 추력 조절
-    if (distToCheckpoint < CHECKPOINT_RADIUS * 3) {
+    // 체크포인트에 가까워지면 적응형 추력 조절 (최적 라인 속도보다 느리면 감속하지 않음)
+    if (distToCheckpoint < CHECKPOINT_RADIUS * 3 &&
+        currentSpeed > racingLineSpeed(state, pod.nextCheckpointId, distToCheckpoint)) {
         // 접근 속도 (속도 벡터의 체크포인트 방향 성분)
         float approachSpeed = currentSpeed * directionAlignment;
         
@@ -470,10 +1039,11 @@ int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Chec
         
         // 정밀한 감속 요인 계산
         float speedRatio = stoppingDistance / (float)distToCheckpoint;
-        float decelFactor = fminf(1.0f, speedRatio * 1.2f); // 안전 마진 20% 추가
+        float decelFactor = fminf(1.0f, speedRatio * botParams.brakeMargin); // 안전 마진 추가
         
         // 더 정밀한 추력 계산
-        float thrustMultiplier = fmaxf(0.3f, 1.0f - decelFactor * (0.6f + 0.4f * (currentSpeed / 200.0f)));
+        float thrustMultiplier = fmaxf(botParams.minThrustMultiplier,
+            1.0f - decelFactor * (botParams.brakeBase + botParams.brakeSpeedWeight * (currentSpeed / 200.0f)));
         baseThrust *= thrustMultiplier;
         
         // 방향이 맞지 않을 때 추가 감속
@@ -485,23 +1055,8 @@ int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Chec
     }
     // 코너링을 위한 추력 조절 (다음 체크포인트 각도 차이가 큰 경우)
     else if (distToCheckpoint < CHECKPOINT_RADIUS * 5) {
-        int nextCpId = (pod.nextCheckpointId + 1) % checkpointCount;
-        Vector currentCp = checkpoints[pod.nextCheckpointId].position;
-        Vector nextCp = checkpoints[nextCpId].position;
-        
-        // 정밀한 각도 계산을 위해 atan2 사용
-        float currentAngle = atan2f(dirVector.y, dirVector.x);
-        float nextAngle = atan2f(nextCp.y - currentCp.y, nextCp.x - currentCp.x);
-        
-        // 각도 차이 계산 (라디안)
-        float angleDiffRad = nextAngle - currentAngle;
-        
-        // 각도 정규화 (-PI ~ PI 범위로)
-        while (angleDiffRad > PI) angleDiffRad -= 2 * PI;
-        while (angleDiffRad < -PI) angleDiffRad += 2 * PI;
-        
-        // 절대 각도 차이를 도(degree)로 변환
-        float turnAngle = fabsf(RAD_TO_DEG(angleDiffRad));
+        // 체크포인트에서 꺾이는 각도 (캐시)
+        float turnAngle = state->racingLine[pod.nextCheckpointId].turnAngle;
         
         // 더 정밀한 코너링 계산
         if (turnAngle > 30) {
@@ -518,7 +1073,7 @@ int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Chec
             float corneringDecel = turnFactor * (1.0f - distFactor) * (0.7f + 0.3f * speedFactor);
             
             // 추력 감소 적용
-            baseThrust *= (1.0f - corneringDecel * 0.6f);
+            baseThrust *= (1.0f - corneringDecel * botParams.corneringDecel);
         }
     }
     
@@ -526,18 +1081,991 @@ int calculateAdaptiveThrust(Pod pod, float angleDiff, int distToCheckpoint, Chec
     return (int)(fmaxf(0.0f, fminf(100.0f, baseThrust)) + 0.5f);
 }
 
+// ===== 물리 엔진 (심판과 동일한 계산 순서: 회전 → 가속 → 이동/충돌 → 마찰 → 절삭/반올림) =====
+
+// 시뮬레이션용 트랙 초기화
+void initSimTrack(SimTrack* track, GameState* state) {
+    track->count = state->checkpointCount;
+    track->totalCheckpoints = state->totalCheckpoints;
+    for (int i = 0; i < state->checkpointCount; i++) {
+        track->x[i] = state->checkpoints[i].position.x;
+        track->y[i] = state->checkpoints[i].position.y;
+    }
+}
+
+// 현재 게임 상태를 시뮬레이션 상태로 변환
+void loadSimState(SimState* sim, GameState* state) {
+    for (int i = 0; i < POD_COUNT; i++) {
+        Pod* pod = i < 2 ? &state->myPods[i] : &state->enemyPods[i - 2];
+        sim->x[i] = pod->position.x;
+        sim->y[i] = pod->position.y;
+        sim->vx[i] = pod->velocity.x;
+        sim->vy[i] = pod->velocity.y;
+        sim->angle[i] = pod->angle;
+        sim->nextCheckpointId[i] = pod->nextCheckpointId;
+        sim->checkpointsPassed[i] = pod->checkpointsPassed;
+        sim->shieldCooldown[i] = pod->shieldCooldown;
+        sim->shieldActive[i] = false;
+    }
+    sim->timeout[0] = state->race.timeout[0];
+    sim->timeout[1] = state->race.timeout[1];
+    sim->boostAvailable[0] = state->myPods[0].boostAvailable && state->myPods[1].boostAvailable;
+    sim->boostAvailable[1] = true;
+    sim->firstTurn = state->firstTurn;
+}
+
+// 상대 위치(dx, dy)와 상대 속도(dvx, dvy)로 두 원의 중심 거리가 radius가 되는 첫 시각 계산
+// solid가 참이면 포드 간 충돌로 보고 서로 멀어지는 중에는 충돌하지 않음
+// maxTime 안에 닿지 않으면 -1 반환
+double simContactTime(double dx, double dy, double dvx, double dvy, double radius, double maxTime, bool solid) {
+    double c = dx * dx + dy * dy - radius * radius;
+    double b = dx * dvx + dy * dvy;
+    if (c <= 0) {
+        // 이미 겹쳐 있음: 체크포인트는 즉시 통과, 포드는 접근 중일 때만 충돌
+        return (!solid || b < 0) ? 0.0 : -1.0;
+    }
+    if (b >= 0) {
+        return -1.0;
+    }
+    double a = dvx * dvx + dvy * dvy;
+    double disc = b * b - a * c;
+    if (disc < 0) {
+        return -1.0;
+    }
+    double t = (-b - sqrt(disc)) / a;
+    return t <= maxTime ? t : -1.0;
+}
+
+// 포드가 목표 지점을 향하기 위해 필요한 회전량 (도, -180 ~ 180)
+double simDiffAngle(const SimState* sim, int pod, double targetX, double targetY) {
+    double dx = targetX - sim->x[pod];
+    double dy = targetY - sim->y[pod];
+    if (dx == 0 && dy == 0) {
+        return 0.0;
+    }
+    double a = RAD_TO_DEG(fastAtan2(dy, dx));
+    if (a < 0) a += 360.0;
+    double angle = sim->angle[pod];
+    double right = angle <= a ? a - angle : 360.0 - angle + a;
+    double left = angle >= a ? angle - a : angle + 360.0 - a;
+    return right < left ? right : -left;
+}
+
+// 회전량을 출력용 목표 지점으로 변환
+Vector simTargetPoint(const SimState* sim, int pod, double rotation) {
+    if (!sim->firstTurn) {
+        rotation = fmax(-MAX_ROTATION, fmin(MAX_ROTATION, rotation));
+    }
+    double rad = DEG_TO_RAD(sim->angle[pod] + rotation);
+    Vector target;
+    target.x = (int)floor(sim->x[pod] + cos(rad) * 10000.0 + 0.5);
+    target.y = (int)floor(sim->y[pod] + sin(rad) * 10000.0 + 0.5);
+    return target;
+}
+
+// 회전과 가속 적용
+void simApplyMove(SimState* sim, const SimMove* move) {
+    for (int i = 0; i < POD_COUNT; i++) {
+        double rotation = move->rotation[i];
+        if (!sim->firstTurn) {
+            rotation = fmax(-MAX_ROTATION, fmin(MAX_ROTATION, rotation));
+        }
+        double angle = sim->angle[i] + rotation;
+        if (angle >= 360.0) angle -= 360.0;
+        else if (angle < 0.0) angle += 360.0;
+        sim->angle[i] = angle;
+
+        int thrust = move->thrust[i];
+        sim->shieldActive[i] = false;
+        if (thrust == THRUST_SHIELD) {
+            // 쉴드 턴 포함 이후 3턴 동안 가속 불가 (턴 종료 시 1 감소)
+            sim->shieldActive[i] = true;
+            sim->shieldCooldown[i] = SHIELD_COOLDOWN + 1;
+            continue;
+        }
+        if (sim->shieldCooldown[i] > 0) {
+            continue;
+        }
+        if (thrust == THRUST_BOOST) {
+            int team = i / 2;
+            thrust = sim->boostAvailable[team] ? BOOST_THRUST : 100;
+            sim->boostAvailable[team] = false;
+        }
+
+        double sinA, cosA;
+        fastSinCos(angle, &sinA, &cosA);
+        sim->vx[i] += cosA * thrust;
+        sim->vy[i] += sinA * thrust;
+    }
+}
+
+// 두 포드의 탄성 충돌 처리 (최소 충격량 120)
+void simBounce(SimState* sim, int a, int b) {
+    double ma = sim->shieldActive[a] ? SHIELD_MASS : 1.0;
+    double mb = sim->shieldActive[b] ? SHIELD_MASS : 1.0;
+    double mcoeff = (ma + mb) / (ma * mb);
+
+    double nx = sim->x[a] - sim->x[b];
+    double ny = sim->y[a] - sim->y[b];
+    double nxnySquare = nx * nx + ny * ny;
+    if (nxnySquare == 0) {
+        return;
+    }
+    double dvx = sim->vx[a] - sim->vx[b];
+    double dvy = sim->vy[a] - sim->vy[b];
+    double product = nx * dvx + ny * dvy;
+    double fx = (nx * product) / (nxnySquare * mcoeff);
+    double fy = (ny * product) / (nxnySquare * mcoeff);
+
+    sim->vx[a] -= fx / ma;
+    sim->vy[a] -= fy / ma;
+    sim->vx[b] += fx / mb;
+    sim->vy[b] += fy / mb;
+
+    // 충격량이 최소값보다 작으면 120으로 맞춰 한 번 더 밀어냄
+    double impulse = sqrt(fx * fx + fy * fy);
+    if (impulse > 0 && impulse < MIN_IMPULSE) {
+        fx = fx * MIN_IMPULSE / impulse;
+        fy = fy * MIN_IMPULSE / impulse;
+    }
+
+    sim->vx[a] -= fx / ma;
+    sim->vy[a] -= fy / ma;
+    sim->vx[b] += fx / mb;
+    sim->vy[b] += fy / mb;
+}
+
+// 체크포인트 통과 처리
+void simPassCheckpoint(SimState* sim, int pod) {
+    sim->nextCheckpointId[pod] = (sim->nextCheckpointId[pod] + 1) % simTrack.count;
+    sim->checkpointsPassed[pod]++;
+    sim->timeout[pod / 2] = TIMEOUT_TURNS;
+}
+
+// 한 턴 동안의 연속 시간 이동 (가장 먼저 일어나는 충돌/체크포인트 통과부터 순서대로 처리)
+void simMovePods(SimState* sim) {
+    double t = 0.0;
+
+    for (int events = 0; events < 32; events++) {
+        double first = 1.0 - t;
+        int eventA = -1;
+        int eventB = -1;  // -1이면 체크포인트 통과 이벤트
+
+        for (int i = 0; i < POD_COUNT; i++) {
+            int cp = sim->nextCheckpointId[i];
+            double tc = simContactTime(sim->x[i] - simTrack.x[cp], sim->y[i] - simTrack.y[cp],
+                                       sim->vx[i], sim->vy[i], CHECKPOINT_RADIUS, first, false);
+            if (tc >= 0 && (tc < first || eventA < 0)) {
+                first = tc;
+                eventA = i;
+                eventB = -1;
+            }
+        }
+
+        for (int i = 0; i < POD_COUNT; i++) {
+            for (int j = i + 1; j < POD_COUNT; j++) {
+                double tc = simContactTime(sim->x[i] - sim->x[j], sim->y[i] - sim->y[j],
+                                           sim->vx[i] - sim->vx[j], sim->vy[i] - sim->vy[j],
+                                           2 * POD_RADIUS, first, true);
+                if (tc >= 0 && (tc < first || eventA < 0)) {
+                    first = tc;
+                    eventA = i;
+                    eventB = j;
+                }
+            }
+        }
+
+        // 이벤트 시각까지(없으면 턴 끝까지) 모든 포드 이동
+        for (int i = 0; i < POD_COUNT; i++) {
+            sim->x[i] += sim->vx[i] * first;
+            sim->y[i] += sim->vy[i] * first;
+        }
+        t += first;
+
+        if (eventA < 0) {
+            return;
+        }
+        if (eventB < 0) {
+            simPassCheckpoint(sim, eventA);
+        } else {
+            simBounce(sim, eventA, eventB);
+        }
+    }
+
+    // 이벤트가 비정상적으로 많으면 남은 시간만큼 그대로 이동
+    for (int i = 0; i < POD_COUNT; i++) {
+        sim->x[i] += sim->vx[i] * (1.0 - t);
+        sim->y[i] += sim->vy[i] * (1.0 - t);
+    }
+}
+
+// 턴 종료: 마찰 적용 후 속도는 절삭, 위치는 반올림 (SIMD 사용 가능하면 4개 포드를 한 번에 처리)
+void simEndTurn(SimState* sim) {
+#if defined(__AVX__)
+    __m256d half = _mm256_set1_pd(0.5);
+    __m256d friction = _mm256_set1_pd(FRICTION);
+    _mm256_storeu_pd(sim->x, _mm256_floor_pd(_mm256_add_pd(_mm256_loadu_pd(sim->x), half)));
+    _mm256_storeu_pd(sim->y, _mm256_floor_pd(_mm256_add_pd(_mm256_loadu_pd(sim->y), half)));
+    _mm256_storeu_pd(sim->vx, _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(sim->vx), friction))));
+    _mm256_storeu_pd(sim->vy, _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_loadu_pd(sim->vy), friction))));
+#elif defined(__SSE2__)
+    __m128d half = _mm_set1_pd(0.5);
+    __m128d one = _mm_set1_pd(1.0);
+    __m128d friction = _mm_set1_pd(FRICTION);
+    for (int i = 0; i < POD_COUNT; i += 2) {
+        // floor(x + 0.5): 절삭 후 절삭값이 더 크면 1을 뺌 (음수 좌표 대응)
+        __m128d px = _mm_add_pd(_mm_loadu_pd(&sim->x[i]), half);
+        __m128d tx = _mm_cvtepi32_pd(_mm_cvttpd_epi32(px));
+        _mm_storeu_pd(&sim->x[i], _mm_sub_pd(tx, _mm_and_pd(_mm_cmpgt_pd(tx, px), one)));
+        __m128d py = _mm_add_pd(_mm_loadu_pd(&sim->y[i]), half);
+        __m128d ty = _mm_cvtepi32_pd(_mm_cvttpd_epi32(py));
+        _mm_storeu_pd(&sim->y[i], _mm_sub_pd(ty, _mm_and_pd(_mm_cmpgt_pd(ty, py), one)));
+        _mm_storeu_pd(&sim->vx[i], _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(&sim->vx[i]), friction))));
+        _mm_storeu_pd(&sim->vy[i], _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(&sim->vy[i]), friction))));
+    }
+#else
+    for (int i = 0; i < POD_COUNT; i++) {
+        sim->x[i] = floor(sim->x[i] + 0.5);
+        sim->y[i] = floor(sim->y[i] + 0.5);
+        sim->vx[i] = (double)(int)(sim->vx[i] * FRICTION);
+        sim->vy[i] = (double)(int)(sim->vy[i] * FRICTION);
+    }
+#endif
+    for (int i = 0; i < POD_COUNT; i++) {
+        if (sim->shieldCooldown[i] > 0) {
+            sim->shieldCooldown[i]--;
+        }
+    }
+    sim->timeout[0]--;
+    sim->timeout[1]--;
+    sim->firstTurn = false;
+}
+
+// 한 턴 전체 시뮬레이션
+void simulateTurn(SimState* sim, const SimMove* move) {
+    simApplyMove(sim, move);
+    simMovePods(sim);
+    simEndTurn(sim);
+}
+
+// 승리 팀 판정 (0 = 나, 1 = 상대, -1 = 진행 중)
+int simWinner(const SimState* sim) {
+    for (int i = 0; i < POD_COUNT; i++) {
+        if (sim->checkpointsPassed[i] >= simTrack.totalCheckpoints) {
+            return i / 2;
+        }
+    }
+    if (sim->timeout[0] <= 0) return 1;
+    if (sim->timeout[1] <= 0) return 0;
+    return -1;
+}
+
+// ===== 레이싱 라인 캐시 (초기화 때 한 번만 계산, 턴 루프에서는 조회만) =====
+
+// 이전 체크포인트에서 출발해 entry를 목표로 checkpointId를 통과하고 다음 체크포인트까지 가는 주행 시뮬레이션
+// 반환값: 다음 체크포인트 통과까지 걸린 턴 수 (작을수록 좋음), out이 있으면 속도 프로파일과 구간 소요 턴 기록
+double simulateRacingLine(GameState* state, int checkpointId, Vector entry, bool boost, RacingLineEntry* out) {
+    int count = state->checkpointCount;
+    int prevId = (checkpointId + count - 1) % count;
+
+    // 포드 0만 주행하고 나머지는 트랙 밖 멀리 세워 둠
+    SimState sim;
+    memset(&sim, 0, sizeof(sim));
+    for (int i = 1; i < POD_COUNT; i++) {
+        sim.x[i] = -1000000.0 * i;
+        sim.y[i] = -1000000.0;
+    }
+    double dx = simTrack.x[checkpointId] - simTrack.x[prevId];
+    double dy = simTrack.y[checkpointId] - simTrack.y[prevId];
+    double len = sqrt(dx * dx + dy * dy);
+    sim.x[0] = simTrack.x[prevId];
+    sim.y[0] = simTrack.y[prevId];
+    sim.vx[0] = (double)(int)(dx / len * LINE_ENTRY_SPEED);
+    sim.vy[0] = (double)(int)(dy / len * LINE_ENTRY_SPEED);
+    sim.angle[0] = RAD_TO_DEG(atan2(dy, dx));
+    if (sim.angle[0] < 0) sim.angle[0] += 360.0;
+    sim.nextCheckpointId[0] = checkpointId;
+    sim.timeout[0] = sim.timeout[1] = LINE_MAX_TURNS + 1;
+    return driveRacingLine(state, &sim, checkpointId, entry, boost, out);
+}
+
+// sim의 포드 0이 entry를 목표로 checkpointId와 그다음 체크포인트를 통과할 때까지 주행 (boost면 처음 정렬된 턴에 부스트)
+double driveRacingLine(GameState* state, SimState* start, int checkpointId, Vector entry, bool boost, RacingLineEntry* out) {
+    int count = state->checkpointCount;
+    int nextId = (checkpointId + 1) % count;
+    Vector nextTarget = state->racingLine[nextId].entryPoint;
+    SimState sim = *start;
+    sim.checkpointsPassed[0] = 0;
+    sim.boostAvailable[0] = boost;
+
+    if (out != NULL) {
+        memset(out->speedProfile, 0, sizeof(out->speedProfile));
+        out->segmentTurns = LINE_MAX_TURNS;
+    }
+
+    SimMove move;
+    memset(&move, 0, sizeof(move));
+    for (int turn = 0; turn < LINE_MAX_TURNS; turn++) {
+        bool approaching = sim.nextCheckpointId[0] == checkpointId;
+        Vector target = approaching ? entry : nextTarget;
+        double rotation = simDiffAngle(&sim, 0, target.x, target.y);
+        double remaining = sim.firstTurn ? 0.0 : fmax(0.0, fabs(rotation) - MAX_ROTATION);
+        move.rotation[0] = rotation;
+        move.thrust[0] = remaining >= 90.0 ? 0 : (int)(100.0 * cos(DEG_TO_RAD(remaining)));
+        if (sim.boostAvailable[0] && approaching && remaining == 0.0) {
+            move.thrust[0] = THRUST_BOOST;
+        }
+
+        // 통과 전 체크포인트까지 거리 구간별 최고 속도 기록
+        if (out != NULL && approaching) {
+            double cx = simTrack.x[checkpointId] - sim.x[0];
+            double cy = simTrack.y[checkpointId] - sim.y[0];
+            int bin = (int)(sqrt(cx * cx + cy * cy) / SPEED_PROFILE_STEP);
+            int speed = (int)sqrt(sim.vx[0] * sim.vx[0] + sim.vy[0] * sim.vy[0]);
+            if (bin < SPEED_PROFILE_BINS && speed > out->speedProfile[bin]) {
+                out->speedProfile[bin] = speed;
+            }
+        }
+
+        simulateTurn(&sim, &move);
+
+        if (approaching && sim.nextCheckpointId[0] != checkpointId && out != NULL) {
+            out->segmentTurns = turn + 1;
+        }
+        if (sim.checkpointsPassed[0] >= 2) {
+            // 동률이면 다음 구간 방향으로 더 빠르게 빠져나간 라인을 선호
+            int afterId = (nextId + 1) % count;
+            double ax = simTrack.x[afterId] - sim.x[0];
+            double ay = simTrack.y[afterId] - sim.y[0];
+            double alen = sqrt(ax * ax + ay * ay);
+            double exitSpeed = alen > 0 ? (sim.vx[0] * ax + sim.vy[0] * ay) / alen : 0.0;
+            return turn + 1 - exitSpeed / 2000.0;
+        }
+    }
+    return LINE_MAX_TURNS + 1;
+}
+
+// 체크포인트마다 진입점 후보(원 둘레 여러 반경과 각도)를 시뮬레이션해 가장 빠른 라인을 캐시
+void precomputeRacingLine(GameState* state) {
+    double startMs = getTimeMs();
+    int count = state->checkpointCount;
+
+    // 초기값: 체크포인트 중심 (다음 구간 목표로도 쓰이므로 먼저 채움)
+    for (int i = 0; i < count; i++) {
+        state->racingLine[i].entryPoint = state->checkpoints[i].position;
+    }
+
+    // 두 번 반복: 두 번째에는 다음 체크포인트의 캐시된 진입점을 출구 목표로 사용
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < count; i++) {
+            Vector center = state->checkpoints[i].position;
+            Vector bestEntry = center;
+            double bestTime = simulateRacingLine(state, i, center, false, NULL);
+
+            // 기존 베지어 곡선 목표점 (이전 → 현재 → 다음 → 그다음 체크포인트)도 후보로 포함
+            BezierCurve curve = createBezierCurve(
+                state->checkpoints[(i + count - 1) % count].position, center,
+                state->checkpoints[(i + 1) % count].position,
+                state->checkpoints[(i + 2) % count].position);
+            Vector bezierEntry = evaluateBezierCurve(curve, 0.5f);
+            double t = simulateRacingLine(state, i, bezierEntry, false, NULL);
+            if (t < bestTime) {
+                bestTime = t;
+                bestEntry = bezierEntry;
+            }
+
+            for (int r = 1; r <= LINE_CANDIDATE_RADII; r++) {
+                double radius = (CHECKPOINT_RADIUS - 50) * r / (double)LINE_CANDIDATE_RADII;
+                for (int a = 0; a < LINE_CANDIDATE_ANGLES; a++) {
+                    double rad = 2.0 * PI * a / LINE_CANDIDATE_ANGLES;
+                    Vector entry;
+                    entry.x = center.x + (int)(cos(rad) * radius);
+                    entry.y = center.y + (int)(sin(rad) * radius);
+                    t = simulateRacingLine(state, i, entry, false, NULL);
+                    if (t < bestTime) {
+                        bestTime = t;
+                        bestEntry = entry;
+                    }
+                }
+            }
+            state->racingLine[i].entryPoint = bestEntry;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        RacingLineEntry* line = &state->racingLine[i];
+        Vector prev = state->checkpoints[(i + count - 1) % count].position;
+        Vector next = state->checkpoints[(i + 1) % count].position;
+
+        double lineTime = simulateRacingLine(state, i, line->entryPoint, false, line);
+        line->boostTurnsSaved = (float)fmax(0.0, lineTime - simulateRacingLine(state, i, line->entryPoint, true, NULL));
+
+        // 기록되지 않은 먼 구간은 바로 아래 구간 속도로, 가까운 빈 구간은 바깥 구간 속도로 채움
+        for (int b = 1; b < SPEED_PROFILE_BINS; b++) {
+            if (line->speedProfile[b] == 0) line->speedProfile[b] = line->speedProfile[b - 1];
+        }
+        for (int b = SPEED_PROFILE_BINS - 2; b >= 0; b--) {
+            if (line->speedProfile[b] == 0) line->speedProfile[b] = line->speedProfile[b + 1];
+        }
+
+        line->exitAngle = RAD_TO_DEG(angleBetween(line->entryPoint, next));
+        float turn = RAD_TO_DEG(angleBetween(state->checkpoints[i].position, next) -
+                                angleBetween(prev, state->checkpoints[i].position));
+        while (turn > 180) turn -= 360;
+        while (turn < -180) turn += 360;
+        line->turnAngle = fabsf(turn);
+
+        fprintf(stderr, "Racing line %d: entry (%d, %d), turn %.0f, %d turns, approach speed %d, boost saves %.2f\n",
+                i, line->entryPoint.x, line->entryPoint.y, line->turnAngle, line->segmentTurns,
+                line->speedProfile[0], line->boostTurnsSaved);
+    }
+    fprintf(stderr, "Racing line cache: %d checkpoints in %.1f ms\n", count, getTimeMs() - startMs);
+}
+
+// ===== 턴 시간 예산 =====
+
+// 단조 증가 시계 (밀리초)
+double getTimeMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 첫 입력 바이트가 올 때까지 기다린 뒤 시계 시작 (입력이 끝났으면 false)
+bool beginTurnBudget(TurnBudget* budget, double budgetMs) {
+    // 지난 턴 마지막 줄의 개행은 건너뛰고 실제 다음 입력을 기다림
+    skipWhitespace(&inputReader);
+    if (peekInput(&inputReader) < 0) {
+        return false;
+    }
+    budget->startMs = getTimeMs();
+    budget->parsedMs = budget->startMs;
+    budget->lastPollMs = budget->startMs;
+    budget->budgetMs = budgetMs;
+    budget->pollCounter = 0;
+    return true;
+}
+
+// 입력 파싱 완료 시각 기록
+void markInputParsed(TurnBudget* budget) {
+    budget->parsedMs = getTimeMs();
+    budget->lastPollMs = budget->parsedMs;
+}
+
+// 예산 중 share 비율까지 사용했을 때의 마감 시각
+double budgetDeadline(const TurnBudget* budget, double share) {
+    return budget->startMs + budget->budgetMs * share;
+}
+
+// 마감 시각이 지났는지 확인 (시계는 BUDGET_POLL_INTERVAL번에 한 번만 읽고 lastPollMs에 보관)
+bool budgetExpired(TurnBudget* budget, double deadlineMs) {
+    if (++budget->pollCounter < BUDGET_POLL_INTERVAL) {
+        return budget->lastPollMs >= deadlineMs;
+    }
+    budget->pollCounter = 0;
+    budget->lastPollMs = getTimeMs();
+    return budget->lastPollMs >= deadlineMs;
+}
+
+// 턴 종료: 파싱/사고 시간, 롤아웃 수, 최악 턴 시간을 stderr로 출력
+void endTurnBudget(TurnBudget* budget, int rollouts) {
+    double endMs = getTimeMs();
+    double totalMs = endMs - budget->startMs;
+    if (totalMs > budget->worstTurnMs) {
+        budget->worstTurnMs = totalMs;
+    }
+    fprintf(stderr, "Turn %d: parse %.2f ms, think %.2f ms, total %.2f / %.0f ms, %d rollouts, worst turn %.2f ms\n",
+            budget->turn, budget->parsedMs - budget->startMs, endMs - budget->parsedMs,
+            totalMs, budget->budgetMs, rollouts, budget->worstTurnMs);
+    budget->turn++;
+}
+
+// ===== 입출력 버퍼 =====
+
+// 버퍼를 다 읽었으면 다시 채움 (입력이 끝났으면 false). 기록 모드면 읽은 원본을 로그에 남김
+bool fillInput(InputReader* reader) {
+    if (reader->position < reader->length) {
+        return true;
+    }
+    ssize_t count;
+    do {
+        count = read(reader->fd, reader->data, sizeof(reader->data));
+    } while (count < 0 && errno == EINTR);
+    reader->position = 0;
+    reader->length = count > 0 ? (int)count : 0;
+    if (count > 0 && replayLog != NULL) {
+        writeReplayRecord(REPLAY_INPUT, reader->data, (unsigned int)count);
+    }
+    return count > 0;
+}
+
+// 다음 바이트를 소비하지 않고 확인 (입력이 끝났으면 -1)
+int peekInput(InputReader* reader) {
+    return fillInput(reader) ? (unsigned char)reader->data[reader->position] : -1;
+}
+
+void skipWhitespace(InputReader* reader) {
+    int c;
+    while ((c = peekInput(reader)) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        reader->position++;
+    }
+}
+
+// 부호 있는 정수 하나 읽기 (숫자가 없으면 false)
+bool readInt(InputReader* reader, int* value) {
+    skipWhitespace(reader);
+    bool negative = peekInput(reader) == '-';
+    if (negative) {
+        reader->position++;
+    }
+    int c = peekInput(reader);
+    if (c < '0' || c > '9') {
+        *value = 0;
+        return false;
+    }
+    int result = 0;
+    while ((c = peekInput(reader)) >= '0' && c <= '9') {
+        result = result * 10 + (c - '0');
+        reader->position++;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+// 모은 출력을 모두 내보내고 버퍼 비우기
+void flushOutput(OutputWriter* writer) {
+    int written = 0;
+    while (written < writer->length) {
+        ssize_t count = write(STDOUT_FILENO, writer->data + written, writer->length - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        written += (int)count;
+    }
+    writer->length = 0;
+}
+
+void writeChar(OutputWriter* writer, char c) {
+    if (writer->length == OUTPUT_BUFFER_SIZE) {
+        flushOutput(writer);
+    }
+    writer->data[writer->length++] = c;
+}
+
+void writeString(OutputWriter* writer, const char* text) {
+    while (*text != '\0') {
+        writeChar(writer, *text++);
+    }
+}
+
+void writeInt(OutputWriter* writer, int value) {
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    if (value < 0) {
+        writeChar(writer, '-');
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        writeChar(writer, digits[--count]);
+    }
+}
+
+// ===== 리플레이 기록 =====
+
+// 로그에 레코드 하나 추가: 종류(1바이트) + 길이(4바이트) + 내용
+void writeReplayRecord(int type, const void* data, unsigned int size) {
+    fputc(type, replayLog);
+    fwrite(&size, sizeof(size), 1, replayLog);
+    fwrite(data, 1, size, replayLog);
+}
+
+// 기록 모드 시작: 헤더를 씀 (이후 입력 버퍼를 채울 때마다 원본이 로그에 추가됨)
+bool startRecording(const char* path) {
+    replayLog = fopen(path, "wb");
+    if (replayLog == NULL) {
+        return false;
+    }
+    ReplayHeader header = {REPLAY_MAGIC, REPLAY_VERSION, botParams};
+    fwrite(&header, sizeof(header), 1, replayLog);
+    return true;
+}
+
+// ===== 롤링 호라이즌 진화 탐색 =====
+
+// xorshift32 난수 (고정 시드로 재현 가능)
+unsigned int nextRandom(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+double randomRange(double low, double high) {
+    return low + (high - low) * (nextRandom() / 4294967296.0);
+}
+
+// 기본 행동: 해당 팀 포드가 다음 체크포인트를 향해 최대 추력
+void defaultTeamMove(const SimState* sim, SimMove* move, int team) {
+    for (int i = team * 2; i < team * 2 + 2; i++) {
+        int cp = sim->nextCheckpointId[i];
+        move->rotation[i] = simDiffAngle(sim, i, simTrack.x[cp], simTrack.y[cp]);
+        move->thrust[i] = 100;
+    }
+}
+
+// 유전자의 한 턴을 해당 팀 포드 명령으로 채움 (genome이 없으면 기본 행동)
+void applyGenomeTurn(const SimState* sim, SimMove* move, int team, const Genome* genome, int turn) {
+    if (genome == NULL) {
+        defaultTeamMove(sim, move, team);
+        return;
+    }
+    for (int k = 0; k < 2; k++) {
+        move->rotation[team * 2 + k] = genome->rotation[k][turn];
+        move->thrust[team * 2 + k] = genome->thrust[k][turn];
+    }
+}
+
+// 포드 진행도 (구간 시간 모델로 추정한 완주까지 남은 턴, 거리 단위로 환산해 부호 반전)
+double podProgress(const SimState* sim, int pod) {
+    int cp = sim->nextCheckpointId[pod];
+    double dx = simTrack.x[cp] - sim->x[pod];
+    double dy = simTrack.y[cp] - sim->y[pod];
+    float turns = estimateTurnsToFinish(&gameState, cp, sim->checkpointsPassed[pod], (float)sqrt(dx * dx + dy * dy));
+    return -gameState.race.distancePerTurn * turns;
+}
+
+// 롤아웃 종료 상태를 team 관점에서 평가: 앞선 아군 포드의 진행, 앞선 상대 포드 견제, 다른 아군 포드의 가로막기 위치
+double evaluateSimState(const SimState* sim, int team) {
+    int winner = simWinner(sim);
+    if (winner == team) return 1e9;
+    if (winner >= 0) return -1e9;
+
+    int mine = team * 2;
+    int theirs = (1 - team) * 2;
+    int runner = podProgress(sim, mine) >= podProgress(sim, mine + 1) ? mine : mine + 1;
+    int blocker = runner == mine ? mine + 1 : mine;
+    int leader = podProgress(sim, theirs) >= podProgress(sim, theirs + 1) ? theirs : theirs + 1;
+
+    int leaderCp = sim->nextCheckpointId[leader];
+    double dx = simTrack.x[leaderCp] - sim->x[blocker];
+    double dy = simTrack.y[leaderCp] - sim->y[blocker];
+
+    return podProgress(sim, runner)
+         - 0.5 * podProgress(sim, leader)
+         + 0.1 * podProgress(sim, blocker)
+         - 0.2 * sqrt(dx * dx + dy * dy);
+}
+
+// 턴 시작 시 역할 배정: 완주까지 남은 턴이 적은 내 포드가 레이서 (여유값 이상 뒤집혀야 교체), 앞선 상대 포드가 목표
+void assignRoles(RoleAssignment* roles, const RaceProgress* race) {
+    const float* left = race->turnsToFinish;
+    if (!roles->assigned) {
+        roles->runner = left[0] <= left[1] ? 0 : 1;
+        roles->assigned = true;
+    } else if (left[1 - roles->runner] + ROLE_SWITCH_TURNS < left[roles->runner]) {
+        roles->runner = 1 - roles->runner;
+    }
+    roles->blocker = 1 - roles->runner;
+    roles->leader = left[2] <= left[3] ? 2 : 3;
+}
+
+// 레이서 탐색 평가: 레이서 진행 - 앞선 상대 진행 견제 (가로막기 포드 계획은 고정)
+double evaluateRunner(const SimState* sim) {
+    int winner = simWinner(sim);
+    if (winner == 0) return 1e9;
+    if (winner >= 0) return -1e9;
+
+    return podProgress(sim, roles.runner)
+         - 0.5 * podProgress(sim, roles.leader)
+         + 0.1 * podProgress(sim, roles.blocker);
+}
+
+// 가로막기 탐색 평가: 앞선 상대의 진행을 늦추고, 롤아웃 중 상대 경로에 가장 가까이 붙고,
+// 상대의 다음 체크포인트 앞을 지킴 (레이서 계획은 고정, 레이서를 방해하면 손해)
+double evaluateBlocker(const SimState* sim, double interceptDistance) {
+    int winner = simWinner(sim);
+    if (winner == 0) return 1e9;
+    if (winner >= 0) return -1e9;
+
+    int leaderCp = sim->nextCheckpointId[roles.leader];
+    double dx = simTrack.x[leaderCp] - sim->x[roles.blocker];
+    double dy = simTrack.y[leaderCp] - sim->y[roles.blocker];
+
+    return 0.5 * podProgress(sim, roles.runner)
+         - podProgress(sim, roles.leader)
+         - 0.2 * sqrt(dx * dx + dy * dy)
+         - 0.2 * interceptDistance;
+}
+
+// 유전자 하나를 SEARCH_DEPTH 턴 동안 시뮬레이션해 슬롯별 목적 함수로 점수 계산 (상대는 opponent 계획대로 이동)
+double evaluateGenome(const SimState* start, Genome* genome, int slot, const Genome* opponent) {
+    int team = slot == SEARCH_OPPONENT ? 1 : 0;
+    SimState sim = *start;
+    SimMove move;
+    double interceptSquared = 1e18;  // 가로막기 포드와 앞선 상대 포드의 롤아웃 중 최소 거리 제곱
+    double boostCost = 0;            // 계획 밖에서 부스트를 쓰면 계획한 구간에서 아낄 턴만큼 손해
+    for (int turn = 0; turn < SEARCH_DEPTH; turn++) {
+        applyGenomeTurn(&sim, &move, team, genome, turn);
+        applyGenomeTurn(&sim, &move, 1 - team, opponent, turn);
+        if (team == 0 && sim.boostAvailable[0] && boostCost == 0
+            && (move.thrust[0] == THRUST_BOOST || move.thrust[1] == THRUST_BOOST) && !boostOnPlan(&sim, &move)) {
+            boostCost = gameState.boostPlan.turnsSaved * gameState.race.distancePerTurn;
+        }
+        simulateTurn(&sim, &move);
+        if (slot == SEARCH_BLOCKER) {
+            double dx = sim.x[roles.leader] - sim.x[roles.blocker];
+            double dy = sim.y[roles.leader] - sim.y[roles.blocker];
+            interceptSquared = fmin(interceptSquared, dx * dx + dy * dy);
+        }
+        if (simWinner(&sim) >= 0) {
+            break;
+        }
+    }
+    searchState[slot].rollouts++;
+    if (slot == SEARCH_RUNNER) {
+        genome->score = evaluateRunner(&sim);
+    } else if (slot == SEARCH_BLOCKER) {
+        genome->score = evaluateBlocker(&sim, sqrt(interceptSquared));
+    } else {
+        genome->score = evaluateSimState(&sim, team);
+    }
+    genome->score -= boostCost;
+    return genome->score;
+}
+
+// 휴리스틱 명령(seeds, 없으면 체크포인트 추적)으로 첫 턴을 채우고 이후 턴은 다음 체크포인트 추적으로 채운 초기 유전자
+void seedGenome(Genome* genome, const SimState* start, int team, PodCommand seeds[2], const Genome* opponent) {
+    SimState sim = *start;
+    SimMove move;
+    for (int turn = 0; turn < SEARCH_DEPTH; turn++) {
+        defaultTeamMove(&sim, &move, team);
+        for (int k = 0; k < 2; k++) {
+            int i = team * 2 + k;
+            if (turn == 0 && seeds != NULL) {
+                move.rotation[i] = simDiffAngle(&sim, i, seeds[k].targetPos.x, seeds[k].targetPos.y);
+                move.thrust[i] = seeds[k].useShield ? THRUST_SHIELD : seeds[k].useBoost ? THRUST_BOOST : seeds[k].thrust;
+            } else if (!(turn == 0 && sim.firstTurn)) {
+                move.rotation[i] = fmax(-MAX_ROTATION, fmin(MAX_ROTATION, move.rotation[i]));
+            }
+            genome->rotation[k][turn] = move.rotation[i];
+            genome->thrust[k][turn] = move.thrust[i];
+        }
+        applyGenomeTurn(&sim, &move, 1 - team, opponent, turn);
+        simulateTurn(&sim, &move);
+    }
+}
+
+// 부모 유전자의 한 턴을 변이 (amplitude가 작을수록 미세 조정, mutablePod가 0/1이면 그 포드만 변이)
+void mutateGenome(Genome* child, const Genome* parent, const SimState* start, int team, int mutablePod, double amplitude) {
+    *child = *parent;
+    int mutations = 1 + nextRandom() % 2;
+    for (int m = 0; m < mutations; m++) {
+        int pod = mutablePod >= 0 ? mutablePod : (int)(nextRandom() % 2);
+        int turn = nextRandom() % SEARCH_DEPTH;
+        unsigned int kind = nextRandom() % 100;
+
+        if (kind < 45) {
+            double rotation = child->rotation[pod][turn] + randomRange(-1.0, 1.0) * MAX_ROTATION * amplitude;
+            if (!(turn == 0 && start->firstTurn)) {
+                rotation = fmax(-MAX_ROTATION, fmin(MAX_ROTATION, rotation));
+            }
+            child->rotation[pod][turn] = rotation;
+        } else if (kind < 95) {
+            int thrust = child->thrust[pod][turn] < 0 ? 100 : child->thrust[pod][turn];
+            thrust += (int)(randomRange(-1.0, 1.0) * 100 * amplitude);
+            child->thrust[pod][turn] = thrust < 0 ? 0 : thrust > 100 ? 100 : thrust;
+        } else if (team == 1) {
+            // 상대 예측에는 쉴드/부스트를 넣지 않음 (사용 여부를 관측할 수 없어 과대 예측됨)
+            continue;
+        } else if (kind < 98) {
+            child->thrust[pod][turn] = THRUST_SHIELD;
+        } else if (start->boostAvailable[team]) {
+            child->thrust[pod][turn] = THRUST_BOOST;
+        }
+    }
+}
+
+// 한 턴 진행 후 유전자를 앞으로 당기고 마지막 턴은 직전 명령을 이어 사용
+void shiftGenome(Genome* genome) {
+    for (int i = 0; i < 2; i++) {
+        for (int turn = 0; turn < SEARCH_DEPTH - 1; turn++) {
+            genome->rotation[i][turn] = genome->rotation[i][turn + 1];
+            genome->thrust[i][turn] = genome->thrust[i][turn + 1];
+        }
+        genome->rotation[i][SEARCH_DEPTH - 1] = 0.0;
+        genome->thrust[i][SEARCH_DEPTH - 1] = 100;
+    }
+}
+
+// 한 포드의 유전자를 source에서 복사
+void copyPodGenes(Genome* genome, const Genome* source, int pod) {
+    memcpy(genome->rotation[pod], source->rotation[pod], sizeof(genome->rotation[pod]));
+    memcpy(genome->thrust[pod], source->thrust[pod], sizeof(genome->thrust[pod]));
+}
+
+// 지난 턴 최고 계획을 한 턴 당긴 예상 계획 (탐색 기록이 없으면 기본 추적 계획)
+void predictedPlan(Genome* plan, const SimState* start, int team, PodCommand seeds[2]) {
+    if (searchState[team].initialized) {
+        *plan = searchState[team].best;
+        shiftGenome(plan);
+    } else {
+        seedGenome(plan, start, team, seeds, NULL);
+    }
+}
+
+// 슬롯별로 제한 시간 동안 진화 탐색 후 최고 유전자 반환 (상대는 opponent 계획을 따른다고 가정)
+// mutablePod가 0/1이면 그 포드만 탐색하고 다른 포드는 fixedPlan대로 움직임
+Genome* runSearch(const SimState* start, int slot, PodCommand seeds[2], const Genome* fixedPlan, int mutablePod,
+                  const Genome* opponent, TurnBudget* budget, double deadlineMs) {
+    int team = slot == SEARCH_OPPONENT ? 1 : 0;
+    SearchState* search = &searchState[slot];
+    Genome* population = search->population;
+    search->rollouts = 0;
+
+    // 이전 턴 개체군을 한 턴 당겨 재사용하고, 마지막 개체는 시드로 교체
+    if (!search->initialized) {
+        for (int k = 0; k < POPULATION_SIZE; k++) {
+            seedGenome(&population[k], start, team, seeds, opponent);
+        }
+        search->initialized = true;
+    } else {
+        for (int k = 0; k < POPULATION_SIZE; k++) {
+            shiftGenome(&population[k]);
+        }
+    }
+    seedGenome(&population[POPULATION_SIZE - 1], start, team, seeds, opponent);
+    if (fixedPlan != NULL) {
+        for (int k = 0; k < POPULATION_SIZE; k++) {
+            copyPodGenes(&population[k], fixedPlan, 1 - mutablePod);
+        }
+    }
+
+    int best = 0;
+    int worst = 0;
+    for (int k = 0; k < POPULATION_SIZE; k++) {
+        evaluateGenome(start, &population[k], slot, opponent);
+        if (population[k].score > population[best].score) best = k;
+        if (population[k].score < population[worst].score) worst = k;
+    }
+
+    // 변이 폭은 시각 대신 롤아웃 진행률로 줄임 (같은 롤아웃 수면 같은 탐색 결과가 나오도록)
+    double startMs = getTimeMs();
+    budget->lastPollMs = startMs;
+    bool replaying = search->rolloutQuota > 0;
+    if (!replaying) {
+        double rate = search->rolloutRate > 0 ? search->rolloutRate : INITIAL_ROLLOUT_RATE;
+        search->expectedRollouts = (float)fmax(1.0, rate * (deadlineMs - startMs));
+    }
+    Genome child;
+    while (replaying ? search->rollouts < search->rolloutQuota : !budgetExpired(budget, deadlineMs)) {
+        double amplitude = 1.0 - 0.9 * fmin(1.0, search->rollouts / search->expectedRollouts);
+
+        // 두 개체 중 나은 쪽을 부모로 선택
+        int a = nextRandom() % POPULATION_SIZE;
+        int b = nextRandom() % POPULATION_SIZE;
+        int parent = population[a].score >= population[b].score ? a : b;
+
+        mutateGenome(&child, &population[parent], start, team, mutablePod, amplitude);
+        evaluateGenome(start, &child, slot, opponent);
+
+        // 가장 나쁜 개체보다 좋으면 교체
+        if (child.score > population[worst].score) {
+            population[worst] = child;
+            if (child.score > population[best].score) {
+                best = worst;
+            }
+            worst = 0;
+            for (int k = 1; k < POPULATION_SIZE; k++) {
+                if (population[k].score < population[worst].score) worst = k;
+            }
+        }
+    }
+
+    if (!replaying) {
+        double elapsedMs = getTimeMs() - startMs;
+        if (elapsedMs > 0.5) {
+            search->rolloutRate = search->rollouts / elapsedMs;
+        }
+    }
+
+    search->best = population[best];
+    return &search->best;
+}
+
+// 최고 유전자의 첫 턴을 출력 명령으로 변환
+PodCommand genomeToCommand(const Genome* genome, const SimState* start, int pod) {
+    PodCommand cmd;
+    cmd.podId = pod;
+    cmd.targetPos = simTargetPoint(start, pod, genome->rotation[pod][0]);
+    cmd.thrust = genome->thrust[pod][0] < 0 ? 100 : genome->thrust[pod][0];
+    cmd.useShield = genome->thrust[pod][0] == THRUST_SHIELD;
+    cmd.useBoost = genome->thrust[pod][0] == THRUST_BOOST && start->boostAvailable[0];
+    return cmd;
+}
+
+// 지난 턴 예측과 실제 상대 위치를 비교해 예측 오차 갱신
+void updateOpponentModel(OpponentModel* model, const SimState* sim) {
+    if (!model->hasPrediction) {
+        return;
+    }
+    double searchError = 0.0;
+    double chaseError = 0.0;
+    for (int k = 0; k < 2; k++) {
+        searchError += hypot(model->searchX[k] - sim->x[2 + k], model->searchY[k] - sim->y[2 + k]);
+        chaseError += hypot(model->chaseX[k] - sim->x[2 + k], model->chaseY[k] - sim->y[2 + k]);
+    }
+    model->searchError = PREDICTION_ERROR_DECAY * model->searchError + (1.0 - PREDICTION_ERROR_DECAY) * searchError;
+    model->chaseError = PREDICTION_ERROR_DECAY * model->chaseError + (1.0 - PREDICTION_ERROR_DECAY) * chaseError;
+}
+
+// 내 탐색에서 사용할 상대 계획 선택 (NULL이면 기본 추적)
+const Genome* chooseOpponentPlan(const OpponentModel* model, const Genome* searchPlan) {
+    return model->searchError <= model->chaseError ? searchPlan : NULL;
+}
+
+// 이번 턴 명령으로 한 턴 진행했을 때의 상대 위치를 두 모델로 예측해 저장
+void recordOpponentPrediction(OpponentModel* model, const SimState* sim, const Genome* myPlan, const Genome* searchPlan) {
+    SimState withSearch = *sim;
+    SimState withChase = *sim;
+    SimMove move;
+
+    applyGenomeTurn(&withSearch, &move, 0, myPlan, 0);
+    applyGenomeTurn(&withSearch, &move, 1, searchPlan, 0);
+    simulateTurn(&withSearch, &move);
+
+    applyGenomeTurn(&withChase, &move, 0, myPlan, 0);
+    applyGenomeTurn(&withChase, &move, 1, NULL, 0);
+    simulateTurn(&withChase, &move);
+
+    for (int k = 0; k < 2; k++) {
+        model->searchX[k] = withSearch.x[2 + k];
+        model->searchY[k] = withSearch.y[2 + k];
+        model->chaseX[k] = withChase.x[2 + k];
+        model->chaseY[k] = withChase.y[2 + k];
+    }
+    model->hasPrediction = true;
+}
+
 // 게임 초기화 함수
 void initializeGame(GameState* state) {
     // 초기화 입력 처리
-    scanf("%d", &state->laps);
-    scanf("%d", &state->checkpointCount);
+    readInt(&inputReader, &state->laps);
+    readInt(&inputReader, &state->checkpointCount);
     
     state->totalCheckpoints = state->laps * state->checkpointCount;
     state->firstTurn = true;
     
     // 체크포인트 정보 저장
     for (int i = 0; i < state->checkpointCount; i++) {
-        scanf("%d%d", &state->checkpoints[i].position.x, &state->checkpoints[i].position.y);
+        readInt(&inputReader, &state->checkpoints[i].position.x);
+        readInt(&inputReader, &state->checkpoints[i].position.y);
         state->checkpoints[i].radius = CHECKPOINT_RADIUS;
     }
     
@@ -551,24 +2079,37 @@ void initializeGame(GameState* state) {
         }
     }
     
+    initSimTrack(&simTrack, state);
+    precomputeRacingLine(state);
+    precomputeSegmentModel(state);
+    
     // 포드 초기화
     for (int i = 0; i < 2; i++) {
         state->myPods[i].boostAvailable = true;
         state->myPods[i].shieldCooldown = 0;
         state->myPods[i].checkpointsPassed = 0;
+        state->enemyPods[i].checkpointsPassed = 0;
     }
 }
 
 // 게임 상태 업데이트 함수
 void updateGameState(GameState* state) {
+    bool passed[2] = {false, false};  // 팀별 이번 턴 체크포인트 통과 여부 (타임아웃 초기화)
+    
     // 내 포드 정보 입력
     for (int i = 0; i < 2; i++) {
         int x, y, vx, vy, angle, nextCheckPointId;
-        scanf("%d%d%d%d%d%d", &x, &y, &vx, &vy, &angle, &nextCheckPointId);
+        readInt(&inputReader, &x);
+        readInt(&inputReader, &y);
+        readInt(&inputReader, &vx);
+        readInt(&inputReader, &vy);
+        readInt(&inputReader, &angle);
+        readInt(&inputReader, &nextCheckPointId);
         
         // 체크포인트를 통과했는지 확인
         if (state->myPods[i].nextCheckpointId != nextCheckPointId && !state->firstTurn) {
             state->myPods[i].checkpointsPassed++;
+            passed[0] = true;
         }
         
         state->myPods[i].position.x = x;
@@ -583,39 +2124,44 @@ void updateGameState(GameState* state) {
             state->myPods[i].shieldCooldown--;
         }
         
-        // 진행 상황 계산
-        state->myPodsInfo[i].progress = calculateProgress(
-            state->myPods[i], 
-            state->checkpoints, 
-            state->checkpointCount
-        );
-        
-        // 베지어 곡선 경로 계산
-        state->myPodsInfo[i].racingCurve = calculateRacingCurve(
-            state->myPods[i], 
-            state->checkpoints, 
-            state->checkpointCount
-        );
+        // 레이싱 라인 목표점 (캐시 조회)
+        state->myPodsInfo[i].racingLine = calculateRacingLine(state->myPods[i], state);
     }
     
-    // 적 포드 정보 입력 및 진행 상황 계산
+    // 적 포드 정보 입력 (통과한 체크포인트 수도 내 포드와 같은 방식으로 추적)
     for (int i = 0; i < 2; i++) {
-        scanf("%d%d%d%d%d%d", 
-              &state->enemyPods[i].position.x, &state->enemyPods[i].position.y,
-              &state->enemyPods[i].velocity.x, &state->enemyPods[i].velocity.y,
-              &state->enemyPods[i].angle, &state->enemyPods[i].nextCheckpointId);
-              
-        // 적 진행 상황 계산
-        state->enemyProgress[i] = calculateProgress(
-            state->enemyPods[i], 
-            state->checkpoints, 
-            state->checkpointCount
-        );
+        int previousCheckpointId = state->enemyPods[i].nextCheckpointId;
+        readInt(&inputReader, &state->enemyPods[i].position.x);
+        readInt(&inputReader, &state->enemyPods[i].position.y);
+        readInt(&inputReader, &state->enemyPods[i].velocity.x);
+        readInt(&inputReader, &state->enemyPods[i].velocity.y);
+        readInt(&inputReader, &state->enemyPods[i].angle);
+        readInt(&inputReader, &state->enemyPods[i].nextCheckpointId);
+        
+        if (state->enemyPods[i].nextCheckpointId != previousCheckpointId && !state->firstTurn) {
+            state->enemyPods[i].checkpointsPassed++;
+            passed[1] = true;
+        }
+    }
+    
+    // 팀별 타임아웃 (첫 턴은 이동 전이므로 그대로)
+    if (!state->firstTurn) {
+        for (int team = 0; team < 2; team++) {
+            state->race.timeout[team] = passed[team] ? TIMEOUT_TURNS : state->race.timeout[team] - 1;
+        }
+    }
+    
+    // 진행 상황 계산
+    updateRaceProgress(state);
+    
+    // 부스트 계획은 첫 턴과 내 포드가 체크포인트를 통과했을 때만 다시 계산
+    if (state->firstTurn || passed[0]) {
+        planBoost(state);
     }
 }
 
 // 포드 전략 결정 함수
-PodCommand determinePodStrategy(Pod pod, Pod otherPod, Pod enemies[], GameState* state, int podIndex) {
+PodCommand determinePodStrategy(Pod pod, GameState* state, int podIndex) {
     PodCommand cmd;
     cmd.podId = podIndex;
     cmd.useShield = false;
@@ -623,9 +2169,8 @@ PodCommand determinePodStrategy(Pod pod, Pod otherPod, Pod enemies[], GameState*
     
     Checkpoint targetCP = state->checkpoints[pod.nextCheckpointId];
     
-    // 최적의 레이싱 라인 계산
-    int lookAhead = 2; // 앞의 2개 체크포인트까지 고려
-    cmd.targetPos = calculateRacingLine(pod, state->checkpoints, state->checkpointCount, lookAhead);
+    // 최적의 레이싱 라인 목표점 (초기화 때 계산한 캐시)
+    cmd.targetPos = calculateRacingLine(pod, state);
     
     // 원치 않는 드리프트 보상
     Vector futurePos;
@@ -681,88 +2226,236 @@ PodCommand determinePodStrategy(Pod pod, Pod otherPod, Pod enemies[], GameState*
     }
     
     // 속도와 거리에 기반한 적응형 추력 계산
-    cmd.thrust = calculateAdaptiveThrust(pod, angleDiff, (int)currDist, state->checkpoints, state->checkpointCount);
+    cmd.thrust = calculateAdaptiveThrust(pod, angleDiff, (int)currDist, state);
     
-    // 마지막 체크포인트인지 확인 (랩 완주)
-    bool isLastCheckpoint = (pod.checkpointsPassed + 1) >= state->totalCheckpoints;
-    
-    // 부스트 사용 여부 결정
-    if (pod.boostAvailable && angleDiff < 10 && !isLastCheckpoint) {
-        // 첫 턴 또는 긴 직선 구간에서 부스트 사용
-        if ((podIndex == 0 && state->firstTurn) || currDist > state->longestStretch * 0.6) {
-            cmd.useBoost = true;
-        }
+    // 부스트 사용 여부 결정 (레이스 전체 부스트 계획의 포드와 구간에서만, 마지막 구간 포함)
+    if (pod.boostAvailable && angleDiff < 10 && boostPlanned(state, podIndex)) {
+        cmd.useBoost = true;
     }
     
     // 쉴드 사용 여부 결정
-    cmd.useShield = shouldEnableShield(pod, otherPod, enemies, state->checkpoints, state->checkpointCount);
+    cmd.useShield = false;  // 쉴드는 두 포드 명령이 정해진 뒤 decideShields에서 결정
+    
+    return cmd;
+}
+
+// 가로막기 포드 전략: 앞선 상대보다 상대의 다음 체크포인트에 가까우면 상대의 예상 경로로 요격,
+// 아니면 그 다음 체크포인트로 먼저 가서 기다림 (탐색의 초기 유전자로 사용)
+PodCommand determineBlockerStrategy(Pod pod, Pod enemies[], int leader, GameState* state, int podIndex) {
+    PodCommand cmd;
+    cmd.podId = podIndex;
+    cmd.useBoost = false;
+    
+    Pod target = enemies[leader];
+    Vector leaderCp = state->checkpoints[target.nextCheckpointId].position;
+    
+    if (distanceSquared(pod.position, leaderCp) < distanceSquared(target.position, leaderCp)) {
+        // 체크포인트 도착 전(최대 3턴)의 예상 위치, 마찰 고려 (1 + 0.85 + 0.85^2 + ...)
+        float leadTurns = fminf(3.0f, state->race.turnsToNext[leader + 2]);
+        cmd.targetPos = add(target.position, scale(target.velocity, (1.0f - powf(FRICTION, leadTurns)) / (1.0f - FRICTION)));
+    } else {
+        int nextCpId = (target.nextCheckpointId + 1) % state->checkpointCount;
+        cmd.targetPos = state->checkpoints[nextCpId].position;
+    }
+    
+    float angleToTargetDeg = RAD_TO_DEG(angleBetween(pod.position, cmd.targetPos));
+    float angleDiff = fabsf(angleToTargetDeg - pod.angle);
+    if (angleDiff > 180) {
+        angleDiff = 360 - angleDiff;
+    }
+    cmd.thrust = calculateThrust(angleDiff, distance(pod.position, cmd.targetPos));
+    cmd.useShield = false;  // 쉴드는 두 포드 명령이 정해진 뒤 decideShields에서 결정
     
     return cmd;
 }
 
 // 포드 명령어 실행 함수
 void executePodCommand(PodCommand cmd) {
+    // 출력 버퍼에 쌓아 두고 턴 끝에 한 번에 내보냄
+    writeInt(&outputWriter, cmd.targetPos.x);
+    writeChar(&outputWriter, ' ');
+    writeInt(&outputWriter, cmd.targetPos.y);
     if (cmd.useShield) {
-        printf("%d %d SHIELD POD%d\n", cmd.targetPos.x, cmd.targetPos.y, cmd.podId);
+        writeString(&outputWriter, " SHIELD POD");
+        writeInt(&outputWriter, cmd.podId);
     }
     else if (cmd.useBoost) {
-        printf("%d %d BOOST POD%d\n", cmd.targetPos.x, cmd.targetPos.y, cmd.podId);
+        writeString(&outputWriter, " BOOST POD");
+        writeInt(&outputWriter, cmd.podId);
     }
     else {
-        printf("%d %d %d POD%d thrust:%d\n", cmd.targetPos.x, cmd.targetPos.y, cmd.thrust, cmd.podId, cmd.thrust);
+        writeChar(&outputWriter, ' ');
+        writeInt(&outputWriter, cmd.thrust);
+        writeString(&outputWriter, " POD");
+        writeInt(&outputWriter, cmd.podId);
+        writeString(&outputWriter, " thrust:");
+        writeInt(&outputWriter, cmd.thrust);
     }
+    writeChar(&outputWriter, '\n');
+}
+
+// 회피용 PID 컨트롤러 초기화 (내 포드 × 상대 포드마다 하나씩)
+void initAvoidancePid(void) {
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            avoidancePid[i][j] = initPidController(botParams.pidKp, botParams.pidKi, botParams.pidKd, -100, 100);
+        }
+    }
+}
+
+// 이번 턴 역할을 배정하고 역할별 휴리스틱 명령 + 두 상대 회피 + 쉴드 결정으로 시드 명령을 만듦
+// (playTurn과 튜너가 같은 정책을 쓰도록 공용)
+void buildSeedCommands(GameState* state, RoleAssignment* roles, PidController pids[2][2], PodCommand seeds[2]) {
+    assignRoles(roles, &state->race);
+    int leader = roles->leader - 2;
+    
+    for (int i = 0; i < 2; i++) {
+        if (i == roles->runner) {
+            seeds[i] = determinePodStrategy(
+                state->myPods[i], 
+                state, 
+                i
+            );
+        } else {
+            seeds[i] = determineBlockerStrategy(
+                state->myPods[i], 
+                state->enemyPods, 
+                leader, 
+                state, 
+                i
+            );
+        }
+        
+        // 충돌 예측 및 회피 (두 상대 모두, 가로막기 포드는 목표 상대를 피하지 않음)
+        for (int j = 0; j < 2; j++) {
+            Vector avoidance = predictCollisionWithPid(
+                state->myPods[i], 
+                state->enemyPods[j], 
+                &pids[i][j], 
+                0.1f
+            );
+            if (i == roles->blocker && j == leader) {
+                continue;
+            }
+            seeds[i].targetPos = add(seeds[i].targetPos, avoidance);
+        }
+    }
+    
+    // 쉴드는 네 포드 충돌 결과를 시뮬레이션해 결정
+    decideShields(state, seeds, roles->leader);
+}
+
+// 한 턴 진행: 입력 파싱 → 역할 배정 → 탐색 → 명령 출력 (record에 재현용 값과 결정을 남김)
+void playTurn(GameState* state, TurnRecord* record) {
+    record->rngSeed = rngState;
+    
+    // 게임 상태 업데이트
+    updateGameState(state);
+    markInputParsed(&turnBudget);
+    
+    // 시뮬레이션 상태 생성
+    SimState sim;
+    loadSimState(&sim, state);
+    
+    // 역할 배정과 휴리스틱 전략 결정 (탐색의 초기 유전자로 사용)
+    PodCommand seeds[2];
+    buildSeedCommands(state, &roles, avoidancePid, seeds);
+    int leader = roles.leader - 2;
+    
+    // 상대 예측 탐색: 내 포드는 지난 턴 계획대로 움직인다고 보고 상대의 최선 명령을 찾음
+    Genome myPlan;
+    predictedPlan(&myPlan, &sim, 0, seeds);
+    Genome* enemyPlan = runSearch(&sim, SEARCH_OPPONENT, NULL, NULL, -1, &myPlan,
+                                  &turnBudget, budgetDeadline(&turnBudget, OPPONENT_SEARCH_SHARE));
+    updateOpponentModel(&opponentModel, &sim);
+    const Genome* opponent = chooseOpponentPlan(&opponentModel, enemyPlan);
+    
+    // 레이서 탐색: 가로막기 포드는 지난 턴 계획대로 두고 레이서만 탐색
+    Genome* runnerBest = runSearch(&sim, SEARCH_RUNNER, seeds, &myPlan, roles.runner, opponent,
+                                   &turnBudget, budgetDeadline(&turnBudget, OPPONENT_SEARCH_SHARE + RUNNER_SEARCH_SHARE));
+    
+    // 가로막기 탐색: 레이서 계획을 고정하고 남은 시간 동안 앞선 상대의 예상 경로를 요격
+    Genome* best = runSearch(&sim, SEARCH_BLOCKER, seeds, runnerBest, roles.blocker, opponent,
+                             &turnBudget, budgetDeadline(&turnBudget, 1.0));
+    
+    // 합친 계획을 레이서 슬롯에 보관 (다음 턴 predictedPlan과 레이서 탐색의 출발점)
+    searchState[SEARCH_RUNNER].best = *best;
+    recordOpponentPrediction(&opponentModel, &sim, best, enemyPlan);
+    fprintf(stderr, "Search: runner %d, blocker %d -> enemy %d; %d opponent + %d runner + %d blocker rollouts, "
+            "best score %.0f, opponent model %s (error %.0f / %.0f)\n",
+            roles.runner, roles.blocker, leader,
+            searchState[SEARCH_OPPONENT].rollouts, searchState[SEARCH_RUNNER].rollouts, searchState[SEARCH_BLOCKER].rollouts,
+            best->score, opponent != NULL ? "search" : "chase", opponentModel.searchError, opponentModel.chaseError);
+    
+    for (int i = 0; i < 2; i++) {
+        PodCommand cmd = genomeToCommand(best, &sim, i);
+        record->targetX[i] = (short)cmd.targetPos.x;
+        record->targetY[i] = (short)cmd.targetPos.y;
+        record->thrust[i] = (short)(cmd.useShield ? THRUST_SHIELD : cmd.useBoost ? THRUST_BOOST : cmd.thrust);
+        
+        // 쉴드 사용 시 쿨다운 설정 (다음 턴 시작 시 1 감소)
+        if (cmd.useShield) {
+            state->myPods[i].shieldCooldown = SHIELD_COOLDOWN + 1;
+        }
+        
+        // 부스트 사용 시 부스트 소진 (두 포드 공용)
+        if (cmd.useBoost) {
+            state->myPods[0].boostAvailable = false;
+            state->myPods[1].boostAvailable = false;
+        }
+        
+        // 명령어 실행
+        executePodCommand(cmd);
+    }
+    
+    for (int slot = 0; slot < SEARCH_SLOTS; slot++) {
+        record->rollouts[slot] = searchState[slot].rollouts;
+        record->expectedRollouts[slot] = searchState[slot].expectedRollouts;
+    }
+    record->bestScore = (float)best->score;
+    state->firstTurn = false;
 }
 
 // 메인 함수 (간소화됨)
 int main() {
+    // 휴리스틱 파라미터: 컴파일된 기본값에 환경 변수 BOT_PARAMS("pidKp=0.4,brakeMargin=1.1" 형식)를 덮어씀
+    botParams = DEFAULT_BOT_PARAMS;
+    if (loadBotParams(&botParams, getenv("BOT_PARAMS")) > 0) {
+        fprintf(stderr, "Loaded parameters from BOT_PARAMS\n");
+    }
+    
+    // 기록 모드: 환경 변수 BOT_RECORD 경로에 입력 원본과 턴별 결정을 남김
+    const char* recordPath = getenv("BOT_RECORD");
+    if (recordPath != NULL && !startRecording(recordPath)) {
+        fprintf(stderr, "Cannot record to %s\n", recordPath);
+    }
+    
+    // 첫 턴 시계는 초기화 입력이 도착할 때부터 시작 (초기화 입력과 첫 턴 입력이 함께 옴)
+    if (!beginTurnBudget(&turnBudget, FIRST_TURN_SEARCH_TIME_MS)) {
+        return 0;
+    }
+    
     // 게임 초기화
     initializeGame(&gameState);
     
-    // PID 컨트롤러 초기화
-    PidController pid = initPidController(0.5f, 0.1f, 0.2f, -100, 100);
+    // 회피용 PID 컨트롤러 초기화
+    initAvoidancePid();
     
     // 게임 루프
     while (1) {
-        // 게임 상태 업데이트
-        updateGameState(&gameState);
-        
-        // 각 포드별 전략 결정 및 명령어 실행
-        for (int i = 0; i < 2; i++) {
-            // 포드 전략 결정
-            PodCommand cmd = determinePodStrategy(
-                gameState.myPods[i], 
-                gameState.myPods[1-i], 
-                gameState.enemyPods, 
-                &gameState, 
-                i
-            );
-            
-            // 충돌 예측 및 회피
-            Vector avoidance = predictCollisionWithPid(
-                gameState.myPods[i], 
-                gameState.enemyPods[0], 
-                &pid, 
-                0.1f
-            );
-            
-            // 회피 벡터 적용
-            cmd.targetPos = add(cmd.targetPos, avoidance);
-            
-            // 쉴드 사용 시 쿨다운 설정
-            if (cmd.useShield) {
-                gameState.myPods[i].shieldCooldown = 3;
-            }
-            
-            // 부스트 사용 시 부스트 소진
-            if (cmd.useBoost) {
-                gameState.myPods[i].boostAvailable = false;
-            }
-            
-            // 명령어 실행
-            executePodCommand(cmd);
+        if (!gameState.firstTurn && !beginTurnBudget(&turnBudget, SEARCH_TIME_MS)) {
+            break;
         }
         
-        gameState.firstTurn = false;
+        TurnRecord record;
+        playTurn(&gameState, &record);
+        flushOutput(&outputWriter);
+        endTurnBudget(&turnBudget, searchState[SEARCH_OPPONENT].rollouts + searchState[SEARCH_RUNNER].rollouts
+                                   + searchState[SEARCH_BLOCKER].rollouts);
+        if (replayLog != NULL) {
+            writeReplayRecord(REPLAY_TURN, &record, sizeof(record));
+            fflush(replayLog);
+        }
     }
     
     return 0;
@@ -0,0 +1,217 @@
+// Mad Pod Racing 리플레이 재생기 (기록한 경기를 오프라인에서 그대로 다시 실행)
+//
+// 빌드: gcc -std=gnu11 -O2 -o replay MadPodRacingReplay.c -lm   (기록한 봇과 같은 옵션으로)
+// 기록: BOT_RECORD=game.bin ./bot
+//       아레나에서는 BOT_RECORD=game.bin ./arena ...   -> 게임과 봇마다 game.bin.<게임 번호>.<A|B>에 기록
+// 사용: ./replay <로그 파일> [프로파일할 턴=-1] [반복 수=200] 2>/dev/null
+//       perf record -g ./replay game.bin 57 500   처럼 한 턴만 반복 실행해 프로파일링
+//
+// 로그의 표준 입력 원본을 initializeGame/updateGameState에 다시 넣고, 탐색은 시계 대신 기록된
+// 롤아웃 수만큼 돌려 매 턴 같은 결정(목표, 추력, 최고 점수)이 나오는지 확인
+// 끝나면 불일치 턴과 재생 시간이 가장 긴 턴을 출력
+#include <unistd.h>
+#include <fcntl.h>
+
+#define main botMain
+#include "MadPodRacingGold.c"
+#undef main
+
+#define REPLAY_SLOWEST_TURNS 5
+
+// 프로파일링할 턴 직전의 봇 전체 상태 (반복 실행마다 되돌림)
+typedef struct {
+    GameState gameState;
+    SearchState searchState[SEARCH_SLOTS];
+    RoleAssignment roles;
+    OpponentModel opponentModel;
+    PidController avoidancePid[2][2];
+    TurnBudget turnBudget;
+    unsigned int rngState;
+    InputReader inputReader;
+    off_t inputOffset;
+} ReplaySnapshot;
+
+ReplaySnapshot snapshot;
+
+void saveSnapshot(ReplaySnapshot* saved) {
+    saved->gameState = gameState;
+    memcpy(saved->searchState, searchState, sizeof(searchState));
+    saved->roles = roles;
+    saved->opponentModel = opponentModel;
+    memcpy(saved->avoidancePid, avoidancePid, sizeof(avoidancePid));
+    saved->turnBudget = turnBudget;
+    saved->rngState = rngState;
+    saved->inputReader = inputReader;
+    saved->inputOffset = lseek(inputReader.fd, 0, SEEK_CUR);
+}
+
+void restoreSnapshot(const ReplaySnapshot* saved) {
+    gameState = saved->gameState;
+    memcpy(searchState, saved->searchState, sizeof(searchState));
+    roles = saved->roles;
+    opponentModel = saved->opponentModel;
+    memcpy(avoidancePid, saved->avoidancePid, sizeof(avoidancePid));
+    turnBudget = saved->turnBudget;
+    rngState = saved->rngState;
+    inputReader = saved->inputReader;
+    lseek(inputReader.fd, saved->inputOffset, SEEK_SET);
+}
+
+// 두 턴 기록이 비트 단위로 같은지 (점수도 float 그대로 비교)
+bool sameTurnRecord(const TurnRecord* a, const TurnRecord* b) {
+    if (a->rngSeed != b->rngSeed || a->bestScore != b->bestScore) {
+        return false;
+    }
+    for (int slot = 0; slot < SEARCH_SLOTS; slot++) {
+        if (a->rollouts[slot] != b->rollouts[slot]) return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (a->targetX[i] != b->targetX[i] || a->targetY[i] != b->targetY[i] || a->thrust[i] != b->thrust[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void printTurnRecord(FILE* out, const char* label, const TurnRecord* record) {
+    fprintf(out, "  %s: seed %u, pod0 %d %d %d, pod1 %d %d %d, best %.3f, rollouts %d/%d/%d\n",
+            label, record->rngSeed,
+            record->targetX[0], record->targetY[0], record->thrust[0],
+            record->targetX[1], record->targetY[1], record->thrust[1],
+            record->bestScore, record->rollouts[0], record->rollouts[1], record->rollouts[2]);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <log> [profile turn=-1] [repeat=200]\n", argv[0]);
+        return 1;
+    }
+    int profileTurn = argc > 2 ? atoi(argv[2]) : -1;
+    int repeat = argc > 3 ? atoi(argv[3]) : 200;
+
+    // 로그 전체를 읽어 입력 바이트와 턴 기록으로 분리
+    FILE* file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    ReplayHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+        fprintf(stderr, "%s: not a replay log (version %d)\n", argv[1], REPLAY_VERSION);
+        return 1;
+    }
+    char* input = NULL;
+    size_t inputLength = 0;
+    TurnRecord* records = NULL;
+    int turnCount = 0;
+    int type;
+    while ((type = fgetc(file)) != EOF) {
+        unsigned int size;
+        if (fread(&size, sizeof(size), 1, file) != 1) {
+            break;
+        }
+        if (type == REPLAY_INPUT) {
+            input = realloc(input, inputLength + size);
+            if (fread(input + inputLength, 1, size, file) != size) {
+                break;
+            }
+            inputLength += size;
+        } else if (type == REPLAY_TURN && size == sizeof(TurnRecord)) {
+            records = realloc(records, (turnCount + 1) * sizeof(TurnRecord));
+            if (fread(&records[turnCount], sizeof(TurnRecord), 1, file) != 1) {
+                break;
+            }
+            turnCount++;
+        } else {
+            fprintf(stderr, "%s: unknown record type %d (%u bytes)\n", argv[1], type, size);
+            return 1;
+        }
+    }
+    fclose(file);
+    if (turnCount == 0 || inputLength == 0) {
+        fprintf(stderr, "%s: no recorded turns\n", argv[1]);
+        return 1;
+    }
+
+    // 봇 명령 출력은 버리고, 보고서는 원래 stdout으로
+    FILE* report = fdopen(dup(STDOUT_FILENO), "w");
+    int devNull = open("/dev/null", O_WRONLY);
+    if (report == NULL || devNull < 0 || dup2(devNull, STDOUT_FILENO) < 0) {
+        return 1;
+    }
+
+    // 입력 원본은 임시 파일에 옮겨 봇의 입력 버퍼가 그대로 read하게 함 (프로파일링 때 되감기 가능)
+    FILE* inputFile = tmpfile();
+    if (inputFile == NULL || fwrite(input, 1, inputLength, inputFile) != inputLength || fflush(inputFile) != 0) {
+        return 1;
+    }
+    inputReader.fd = fileno(inputFile);
+    lseek(inputReader.fd, 0, SEEK_SET);
+
+    botParams = header.params;
+    beginTurnBudget(&turnBudget, FIRST_TURN_SEARCH_TIME_MS);
+    initializeGame(&gameState);
+    initAvoidancePid();
+
+    double* turnMs = calloc(turnCount, sizeof(double));
+    int replayed = 0;
+    int mismatches = 0;
+    for (int t = 0; t < turnCount; t++) {
+        if (!gameState.firstTurn && !beginTurnBudget(&turnBudget, SEARCH_TIME_MS)) {
+            fprintf(report, "Input ends before turn %d\n", t);
+            break;
+        }
+
+        // 탐색은 기록된 롤아웃 수만큼만 (시계와 무관하게 같은 결과)
+        const TurnRecord* expected = &records[t];
+        for (int slot = 0; slot < SEARCH_SLOTS; slot++) {
+            searchState[slot].rolloutQuota = expected->rollouts[slot];
+            searchState[slot].expectedRollouts = expected->expectedRollouts[slot];
+        }
+
+        TurnRecord actual;
+        if (t == profileTurn) {
+            saveSnapshot(&snapshot);
+            double bestMs = 1e18;
+            double startMs = getTimeMs();
+            for (int r = 0; r < repeat; r++) {
+                double runMs = getTimeMs();
+                playTurn(&gameState, &actual);
+                outputWriter.length = 0;
+                bestMs = fmin(bestMs, getTimeMs() - runMs);
+                restoreSnapshot(&snapshot);
+            }
+            fprintf(report, "Turn %d x %d: average %.3f ms, best %.3f ms\n",
+                    t, repeat, (getTimeMs() - startMs) / (repeat > 0 ? repeat : 1), bestMs);
+        }
+
+        double startMs = getTimeMs();
+        playTurn(&gameState, &actual);
+        flushOutput(&outputWriter);
+        turnMs[t] = getTimeMs() - startMs;
+        replayed++;
+
+        if (!sameTurnRecord(&actual, expected)) {
+            if (mismatches == 0) {
+                fprintf(report, "Turn %d differs from the log\n", t);
+                printTurnRecord(report, "recorded", expected);
+                printTurnRecord(report, "replayed", &actual);
+            }
+            mismatches++;
+        }
+    }
+
+    fprintf(report, "Replayed %d / %d turns, %d mismatches\n", replayed, turnCount, mismatches);
+    fprintf(report, "Slowest turns:");
+    for (int k = 0; k < REPLAY_SLOWEST_TURNS && k < replayed; k++) {
+        int slowest = 0;
+        for (int t = 1; t < replayed; t++) {
+            if (turnMs[t] > turnMs[slowest]) slowest = t;
+        }
+        fprintf(report, " %d (%.2f ms)", slowest, turnMs[slowest]);
+        turnMs[slowest] = -1;
+    }
+    fprintf(report, "\n");
+    fclose(report);
+    return mismatches == 0 ? 0 : 2;
+}
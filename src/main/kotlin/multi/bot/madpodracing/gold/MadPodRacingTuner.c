@@ -0,0 +1,263 @@
+// Mad Pod Racing 휴리스틱 파라미터 튜너 (SPSA)
+//
+// 빌드: gcc -std=gnu11 -O2 -o tuner MadPodRacingTuner.c -lm
+// 사용: ./tuner [반복 수=200] [트랙 수=32] [워커 수=코어 수] [시드=1]
+//       시작점은 DEFAULT_BOT_PARAMS에 환경 변수 BOT_PARAMS를 덮어쓴 값 (반복 수 0이면 평가만)
+//
+// 고정된 무작위 트랙 묶음에서 휴리스틱 정책(탐색 없이 playTurn과 같은 buildSeedCommands:
+// 레이서/가로막기 역할 배정, 역할별 전략, 두 상대 PID 회피, 쉴드 결정)을
+// 기본 추적 상대와 프로세스 안 시뮬레이션으로 경주시켜 예상 완주 턴 수의 평균을 최소화
+// 반복마다 워커 수만큼의 섭동 쌍을 병렬 프로세스로 평가해 기울기를 평균
+// 끝나면 MadPodRacingGold.c의 DEFAULT_BOT_PARAMS에 붙여 넣을 상수 표를 stdout으로 출력
+#define ARENA_NO_MAIN
+#include "MadPodRacingArena.c"
+
+#define TUNER_MAX_TRACKS 256
+#define TUNER_MAX_WORKERS 64
+#define SPSA_A 0.1            // 스텝 크기 (정규화된 [0,1] 공간, 상대 비용 기울기 기준)
+#define SPSA_C 0.05           // 섭동 크기
+#define SPSA_STABILITY 10.0   // 초반 스텝 완화 상수
+#define SPSA_MAX_STEP 0.05    // 한 번에 움직일 수 있는 최대 거리
+#define TUNER_REPORT_INTERVAL 10
+
+SimTrack tunerTracks[TUNER_MAX_TRACKS];
+GameState tunerStates[TUNER_MAX_TRACKS];
+int tunerTrackCount;
+
+// 시뮬레이션 상태를 휴리스틱 함수가 읽는 GameState 포드 정보로 복사 (updateGameState와 같은 값)
+void storeSimState(GameState* state, const SimState* sim) {
+    bool passed = sim->checkpointsPassed[0] != state->myPods[0].checkpointsPassed
+               || sim->checkpointsPassed[1] != state->myPods[1].checkpointsPassed;
+    for (int i = 0; i < POD_COUNT; i++) {
+        Pod* pod = i < 2 ? &state->myPods[i] : &state->enemyPods[i - 2];
+        pod->position.x = (int)sim->x[i];
+        pod->position.y = (int)sim->y[i];
+        pod->velocity.x = (int)sim->vx[i];
+        pod->velocity.y = (int)sim->vy[i];
+        pod->angle = sim->firstTurn ? -1 : (int)floor(sim->angle[i] + 0.5) % 360;
+        pod->nextCheckpointId = sim->nextCheckpointId[i];
+        pod->checkpointsPassed = sim->checkpointsPassed[i];
+        pod->shieldCooldown = sim->shieldCooldown[i];
+        pod->boostAvailable = sim->boostAvailable[i / 2];
+    }
+    state->firstTurn = sim->firstTurn;
+    updateRaceProgress(state);
+    if (state->firstTurn || passed) {
+        planBoost(state);
+    }
+}
+
+// 정규화된 파라미터 벡터(각 성분 0~1)를 실제 값으로 변환
+BotParams paramsFromTheta(const double theta[BOT_PARAM_COUNT]) {
+    BotParams params = DEFAULT_BOT_PARAMS;
+    for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+        const BotParamInfo* info = &BOT_PARAM_INFO[k];
+        *botParamField(&params, k) = (float)(info->low + theta[k] * (info->high - info->low));
+    }
+    return params;
+}
+
+void thetaFromParams(const BotParams* params, double theta[BOT_PARAM_COUNT]) {
+    BotParams copy = *params;
+    for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+        const BotParamInfo* info = &BOT_PARAM_INFO[k];
+        theta[k] = (*botParamField(&copy, k) - info->low) / (info->high - info->low);
+    }
+}
+
+// 트랙 한 개에서 휴리스틱 정책으로 경주: 비용 = 게임 종료 턴 × 전체 체크포인트 / 앞선 내 포드의 통과 수
+double raceCost(int track, const BotParams* params) {
+    simTrack = tunerTracks[track];
+    // 쉴드 결정의 podProgress처럼 전역 gameState를 읽는 함수가 있으므로 봇과 같이 전역에서 경주
+    gameState = tunerStates[track];
+    GameState* state = &gameState;
+    botParams = *params;
+    RoleAssignment raceRoles = {0};
+    PidController pids[2][2];
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            pids[i][j] = initPidController(params->pidKp, params->pidKi, params->pidKd, -100, 100);
+        }
+    }
+
+    SimState sim;
+    placePods(&sim, &simTrack);
+    int turn;
+    for (turn = 1; turn <= ARENA_MAX_TURNS; turn++) {
+        storeSimState(state, &sim);
+
+        PodCommand cmds[2];
+        buildSeedCommands(state, &raceRoles, pids, cmds);
+        
+        SimMove move;
+        defaultTeamMove(&sim, &move, 1);
+        for (int i = 0; i < 2; i++) {
+            move.rotation[i] = simDiffAngle(&sim, i, cmds[i].targetPos.x, cmds[i].targetPos.y);
+            move.thrust[i] = cmds[i].useShield ? THRUST_SHIELD : cmds[i].useBoost ? THRUST_BOOST : cmds[i].thrust;
+        }
+
+        simulateTurn(&sim, &move);
+        if (simWinner(&sim) >= 0) {
+            break;
+        }
+    }
+
+    int passed = sim.checkpointsPassed[0] > sim.checkpointsPassed[1] ? sim.checkpointsPassed[0] : sim.checkpointsPassed[1];
+    return (double)turn * simTrack.totalCheckpoints / (passed > 0 ? passed : 1);
+}
+
+// 트랙 묶음 전체의 평균 비용
+double averageCost(const BotParams* params) {
+    double total = 0;
+    for (int t = 0; t < tunerTrackCount; t++) {
+        total += raceCost(t, params);
+    }
+    return total / tunerTrackCount;
+}
+
+// 고정 트랙 묶음 생성 (레이싱 라인 캐시는 파라미터와 무관하므로 한 번만 계산)
+void buildTrackSet(int count, unsigned int seed) {
+    // 캐시 계산 로그는 버림
+    fflush(stderr);
+    int savedStderr = dup(STDERR_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDERR_FILENO);
+
+    tunerTrackCount = count;
+    for (int t = 0; t < count; t++) {
+        generateTrack(&tunerTracks[t], seed + t);
+        simTrack = tunerTracks[t];
+
+        GameState* state = &tunerStates[t];
+        memset(state, 0, sizeof(*state));
+        state->laps = ARENA_LAPS;
+        state->checkpointCount = simTrack.count;
+        state->totalCheckpoints = simTrack.totalCheckpoints;
+        for (int i = 0; i < simTrack.count; i++) {
+            state->checkpoints[i].position.x = (int)simTrack.x[i];
+            state->checkpoints[i].position.y = (int)simTrack.y[i];
+            state->checkpoints[i].radius = CHECKPOINT_RADIUS;
+            int dist = (int)hypot(simTrack.x[(i + 1) % simTrack.count] - simTrack.x[i],
+                                  simTrack.y[(i + 1) % simTrack.count] - simTrack.y[i]);
+            if (dist > state->longestStretch) state->longestStretch = dist;
+        }
+        precomputeRacingLine(state);
+        precomputeSegmentModel(state);
+    }
+
+    fflush(stderr);
+    dup2(savedStderr, STDERR_FILENO);
+    close(savedStderr);
+    close(devNull);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    int tracks = argc > 2 ? atoi(argv[2]) : 32;
+    int workers = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int seed = argc > 4 ? (unsigned int)strtoul(argv[4], NULL, 10) : 1;
+    if (tracks < 1) tracks = 1;
+    if (tracks > TUNER_MAX_TRACKS) tracks = TUNER_MAX_TRACKS;
+    if (workers < 1) workers = 1;
+    if (workers > TUNER_MAX_WORKERS) workers = TUNER_MAX_WORKERS;
+
+    double startMs = getTimeMs();
+    buildTrackSet(tracks, seed);
+    rngState = seed * 2654435761u + 1;
+
+    BotParams start = DEFAULT_BOT_PARAMS;
+    loadBotParams(&start, getenv("BOT_PARAMS"));
+    double theta[BOT_PARAM_COUNT];
+    thetaFromParams(&start, theta);
+    double initialCost = averageCost(&start);
+    double bestTheta[BOT_PARAM_COUNT];
+    memcpy(bestTheta, theta, sizeof(theta));
+    double bestCost = initialCost;
+    fprintf(stderr, "%d tracks, %d workers, starting cost %.2f\n", tracks, workers, initialCost);
+
+    for (int iter = 0; iter < iterations; iter++) {
+        double ak = SPSA_A / pow(iter + 1 + SPSA_STABILITY, 0.602);
+        double ck = SPSA_C / pow(iter + 1, 0.101);
+
+        // 워커마다 무작위 ±1 섭동 방향 하나씩
+        double delta[TUNER_MAX_WORKERS][BOT_PARAM_COUNT];
+        for (int w = 0; w < workers; w++) {
+            for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+                delta[w][k] = (nextRandom() & 1) ? 1.0 : -1.0;
+            }
+        }
+
+        // 각 워커가 θ+cΔ, θ-cΔ 두 점을 평가해 파이프로 보고
+        int results[2];
+        if (pipe(results) != 0) {
+            perror("pipe");
+            return 1;
+        }
+        for (int w = 0; w < workers; w++) {
+            if (fork() == 0) {
+                close(results[0]);
+                double plus[BOT_PARAM_COUNT];
+                double minus[BOT_PARAM_COUNT];
+                for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+                    plus[k] = fmin(1.0, fmax(0.0, theta[k] + ck * delta[w][k]));
+                    minus[k] = fmin(1.0, fmax(0.0, theta[k] - ck * delta[w][k]));
+                }
+                BotParams plusParams = paramsFromTheta(plus);
+                BotParams minusParams = paramsFromTheta(minus);
+                double report[3] = {w, averageCost(&plusParams), averageCost(&minusParams)};
+                if (write(results[1], report, sizeof(report)) != sizeof(report)) {
+                    _exit(1);
+                }
+                _exit(0);
+            }
+        }
+        close(results[1]);
+
+        double gradient[BOT_PARAM_COUNT] = {0};
+        double report[3];
+        int reports = 0;
+        while (read(results[0], report, sizeof(report)) == sizeof(report)) {
+            int w = (int)report[0];
+            // 비용 차이를 기준 비용으로 나눠 상대 기울기로 사용 (트랙 묶음에 따라 비용 규모가 달라도 같은 스텝)
+            double diff = (report[1] - report[2]) / (2.0 * ck * bestCost);
+            for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+                gradient[k] += diff * delta[w][k];
+            }
+            reports++;
+        }
+        close(results[0]);
+        while (wait(NULL) > 0) {
+        }
+        if (reports == 0) {
+            continue;
+        }
+
+        for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+            double step = ak * gradient[k] / reports;
+            step = fmax(-SPSA_MAX_STEP, fmin(SPSA_MAX_STEP, step));
+            theta[k] = fmin(1.0, fmax(0.0, theta[k] - step));
+        }
+
+        if ((iter + 1) % TUNER_REPORT_INTERVAL == 0 || iter + 1 == iterations) {
+            BotParams current = paramsFromTheta(theta);
+            double cost = averageCost(&current);
+            if (cost < bestCost) {
+                bestCost = cost;
+                memcpy(bestTheta, theta, sizeof(theta));
+            }
+            fprintf(stderr, "iteration %d: cost %.2f (best %.2f), %.1f s\n",
+                    iter + 1, cost, bestCost, (getTimeMs() - startMs) / 1000.0);
+        }
+    }
+
+    // DEFAULT_BOT_PARAMS에 그대로 붙여 넣을 수 있는 형식으로 출력
+    BotParams best = bestCost < initialCost ? paramsFromTheta(bestTheta) : start;
+    printf("// MadPodRacingTuner: %d tracks (seed %u), %d iterations, cost %.2f -> %.2f\n",
+           tracks, seed, iterations, initialCost, bestCost);
+    printf("const BotParams DEFAULT_BOT_PARAMS = {\n");
+    for (int k = 0; k < BOT_PARAM_COUNT; k++) {
+        printf("    .%s = %.4ff,\n", BOT_PARAM_INFO[k].name, *botParamField(&best, k));
+    }
+    printf("};\n");
+    return 0;
+}
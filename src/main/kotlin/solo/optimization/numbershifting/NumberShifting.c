@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
 
 #define MAX_SIZE 20
 #define MAX_MOVES 1000
@@ -31,6 +33,102 @@ int width, height;
 Move solution[MAX_MOVES];
 int moveCount = 0;
 
+// ===== 입출력 버퍼 (scanf/printf 대신 read/write로 모아서 처리) =====
+
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define OUTPUT_BUFFER_SIZE (1 << 12)
+
+char inputBuffer[INPUT_BUFFER_SIZE];
+int inputLength = 0;
+int inputPosition = 0;
+char outputBuffer[OUTPUT_BUFFER_SIZE];
+int outputLength = 0;
+
+// 다음 바이트를 소비하지 않고 확인 (버퍼가 비면 다시 채우고, 입력이 끝났으면 -1)
+int peekInput() {
+    if (inputPosition == inputLength) {
+        ssize_t count;
+        do {
+            count = read(STDIN_FILENO, inputBuffer, sizeof(inputBuffer));
+        } while (count < 0 && errno == EINTR);
+        inputPosition = 0;
+        inputLength = count > 0 ? (int)count : 0;
+        if (count <= 0) {
+            return -1;
+        }
+    }
+    return (unsigned char)inputBuffer[inputPosition];
+}
+
+// 부호 있는 정수 하나 읽기 (입력이 끝났으면 false)
+bool readInt(int* value) {
+    int c;
+    while ((c = peekInput()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        inputPosition++;
+    }
+    bool negative = c == '-';
+    if (negative) {
+        inputPosition++;
+    }
+    c = peekInput();
+    if (c < '0' || c > '9') {
+        *value = 0;
+        return false;
+    }
+    int result = 0;
+    while ((c = peekInput()) >= '0' && c <= '9') {
+        result = result * 10 + (c - '0');
+        inputPosition++;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+// 모은 출력을 모두 내보내기 (턴마다 한 번)
+void flushOutput() {
+    int written = 0;
+    while (written < outputLength) {
+        ssize_t count = write(STDOUT_FILENO, outputBuffer + written, outputLength - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        written += (int)count;
+    }
+    outputLength = 0;
+}
+
+void writeChar(char c) {
+    if (outputLength == OUTPUT_BUFFER_SIZE) {
+        flushOutput();
+    }
+    outputBuffer[outputLength++] = c;
+}
+
+void writeString(const char* text) {
+    while (*text != '\0') {
+        writeChar(*text++);
+    }
+}
+
+void writeInt(int value) {
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    if (value < 0) {
+        writeChar('-');
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        writeChar(digits[--count]);
+    }
+}
+
 // 그리드 출력 함수 (디버깅용)
 void printGrid() {
     fprintf(stderr, "Grid %dx%d:\n", width, height);
@@ -180,27 +278,32 @@ bool solve(int depth, int maxDepth) {
 // 출력 함수
 void printSolution() {
     for (int i = 0; i < moveCount; i++) {
-        printf("%d %d %c %c\n", 
-               solution[i].x, 
-               solution[i].y, 
-               dirChars[solution[i].dir], 
-               solution[i].add ? '+' : '-');
+        writeInt(solution[i].x);
+        writeChar(' ');
+        writeInt(solution[i].y);
+        writeChar(' ');
+        writeChar(dirChars[solution[i].dir]);
+        writeChar(' ');
+        writeChar(solution[i].add ? '+' : '-');
+        writeChar('\n');
     }
 }
 
 int main()
 {
-    printf("first_level\n");
-    fflush(stdout);
+    writeString("first_level\n");
+    flushOutput();
 
     // game loop
     while (1) {
         moveCount = 0;
-        scanf("%d%d", &width, &height);
+        if (!readInt(&width) || !readInt(&height)) {
+            break;
+        }
         
         for (int y = 0; y < height; y++) {
             for (int x = 0; x < width; x++) {
-                scanf("%d", &grid[x][y]);
+                readInt(&grid[x][y]);
             }
         }
         
@@ -220,10 +323,10 @@ int main()
         } else {
             fprintf(stderr, "Failed to find solution in depth %d\n", maxDepth);
             // 예제 출력 (실제로는 작동하지 않을 수 있음)
-            printf("0 0 R +\n");
+            writeString("0 0 R +\n");
         }
         
-        fflush(stdout);
+        flushOutput();
     }
 
     return 0;
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
 
 #define ROWS 15
 #define COLS 15
@@ -14,6 +16,102 @@ const int dc[] = {0, 1, 0, -1};
 int board[ROWS][COLS];
 int tempBoard[ROWS][COLS];
 
+// ===== 입출력 버퍼 (scanf/printf 대신 read/write로 모아서 처리) =====
+
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define OUTPUT_BUFFER_SIZE (1 << 12)
+
+char inputBuffer[INPUT_BUFFER_SIZE];
+int inputLength = 0;
+int inputPosition = 0;
+char outputBuffer[OUTPUT_BUFFER_SIZE];
+int outputLength = 0;
+
+// 다음 바이트를 소비하지 않고 확인 (버퍼가 비면 다시 채우고, 입력이 끝났으면 -1)
+int peekInput() {
+    if (inputPosition == inputLength) {
+        ssize_t count;
+        do {
+            count = read(STDIN_FILENO, inputBuffer, sizeof(inputBuffer));
+        } while (count < 0 && errno == EINTR);
+        inputPosition = 0;
+        inputLength = count > 0 ? (int)count : 0;
+        if (count <= 0) {
+            return -1;
+        }
+    }
+    return (unsigned char)inputBuffer[inputPosition];
+}
+
+// 부호 있는 정수 하나 읽기 (입력이 끝났으면 false)
+bool readInt(int* value) {
+    int c;
+    while ((c = peekInput()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        inputPosition++;
+    }
+    bool negative = c == '-';
+    if (negative) {
+        inputPosition++;
+    }
+    c = peekInput();
+    if (c < '0' || c > '9') {
+        *value = 0;
+        return false;
+    }
+    int result = 0;
+    while ((c = peekInput()) >= '0' && c <= '9') {
+        result = result * 10 + (c - '0');
+        inputPosition++;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+// 모은 출력을 모두 내보내기 (턴마다 한 번)
+void flushOutput() {
+    int written = 0;
+    while (written < outputLength) {
+        ssize_t count = write(STDOUT_FILENO, outputBuffer + written, outputLength - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        written += (int)count;
+    }
+    outputLength = 0;
+}
+
+void writeChar(char c) {
+    if (outputLength == OUTPUT_BUFFER_SIZE) {
+        flushOutput();
+    }
+    outputBuffer[outputLength++] = c;
+}
+
+void writeString(const char* text) {
+    while (*text != '\0') {
+        writeChar(*text++);
+    }
+}
+
+void writeInt(int value) {
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    if (value < 0) {
+        writeChar('-');
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        writeChar(digits[--count]);
+    }
+}
+
 // 게임판 디버깅용 출력 함수
 void printBoard() {
     fprintf(stderr, "Board state:\n");
@@ -189,22 +287,37 @@ Move findBestMove() {
 int main() {
     // 게임 루프
     while (1) {
-        // 보드 읽기 (위에서 아래로 입력됨)
+        // 보드 읽기 (위에서 아래로 입력됨, 입력이 끝나면 종료)
+        bool ended = false;
         for (int i = ROWS - 1; i >= 0; i--) {
             for (int j = 0; j < COLS; j++) {
-                scanf("%d", &board[i][j]);
+                if (!readInt(&board[i][j])) {
+                    ended = true;
+                }
             }
         }
+        if (ended) {
+            break;
+        }
         
         // 최적의 이동 찾기
         Move bestMove = findBestMove();
         
         if (bestMove.col != -1 && bestMove.row != -1) {
-            printf("%d %d Size: %d, Score: %d\n", 
-                   bestMove.col, bestMove.row, bestMove.size, bestMove.score);
+            writeInt(bestMove.col);
+            writeChar(' ');
+            writeInt(bestMove.row);
+            writeString(" Size: ");
+            writeInt(bestMove.size);
+            writeString(", Score: ");
+            writeInt(bestMove.score);
+            writeChar('\n');
         } else {
-            printf("0 0 No valid moves\n");
+            writeString("0 0 No valid moves\n");
         }
+        
+        // 응답은 턴마다 내보내야 다음 입력이 옴
+        flushOutput();
     }
     
     return 0;
@@ -3,6 +3,9 @@
 #include <string.h>
 #include <stdbool.h>
 #include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
 
 #define MAX_BUILDINGS 150
 #define MAX_TUBES 500
@@ -12,6 +15,41 @@
 #define TELEPORT_COST 5000
 #define POD_COST 1000
 #define POD_DESTROY_REFUND 750
+#define MAX_TUBES_PER_BUILDING 5
+#define BUILDING_ID_HASH_SIZE 512   // 2의 거듭제곱, 최대 건물 수의 3배 이상
+#define UNREACHABLE 10000           // 모듈까지 경로가 없는 거리
+
+// 월간 이동 규칙
+#define MONTH_COUNT 20
+#define MONTH_DAYS 20
+#define POD_CAPACITY 10
+#define SPEED_POINTS 50
+#define BALANCE_POINTS 50
+#define MAX_SIM_GROUPS (MAX_ASTRONAUTS + MAX_PODS * MONTH_DAYS)  // 포드가 찰 때마다 무리가 하나씩 나뉨
+
+// 월간 계획 탐색
+#define PLAN_TIME_MS 400.0          // 턴 제한 500ms
+#define FIRST_PLAN_TIME_MS 850.0    // 첫 턴 제한 1000ms
+#define MAX_POD_ID 500
+#define MAX_PLAN_ACTIONS 256
+#define MAX_CANDIDATES 2048
+#define MAX_LINE_STOPS 12           // 노선 후보의 최대 정류장 수
+#define TUBE_NEIGHBORS 8            // 건물마다 새 튜브 후보로 볼 가까운 건물 수
+#define LINE_HOP_COST 100           // 노선 탐색에서 정류장 하나를 더 거치는 비용 (느려지는 만큼)
+#define INT_MAX_COST 1000000000
+#define TELEPORT_CANDIDATES 12      // 줄어드는 이동 일수가 큰 순으로 평가할 텔레포터 후보 수
+#define LOOP_SEEDS 8                // 순환 포드 노선을 시작할 혼잡한 튜브 수
+#define RELOCATE_PODS 3             // 다른 노선으로 옮겨 볼 한가한 포드 수
+#define LOOKAHEAD_MONTHS 3          // 이번 달 예산 너머로 계획을 이어 갈 달 수
+#define INTEREST_PERCENT 10         // 달이 끝날 때 남은 자원의 이자
+#define UNEVALUATED 1e18            // 아직 평가하지 않은 후보의 자원당 점수 (먼저 평가됨)
+
+// 튜브 건설 검사용 격자 (맵 0~160 x 0~90 km)
+#define GRID_CELL_SIZE 8
+#define GRID_COLUMNS (160 / GRID_CELL_SIZE + 1)
+#define GRID_ROWS (90 / GRID_CELL_SIZE + 1)
+#define GRID_CELLS (GRID_COLUMNS * GRID_ROWS)
+#define GRID_TUBE_ENTRIES (MAX_TUBES * (2 * GRID_COLUMNS + GRID_ROWS))  // 튜브 하나는 열마다 칸 범위 하나씩
 
 // 건물 유형 상수
 #define LANDING_PAD 0
@@ -23,15 +61,19 @@ typedef struct {
     int type;         // 0: 착륙장, 1-20: 달 모듈(타입에 따라)
     int x, y;         // 좌표
     int astronaut_count[MODULE_TYPE_COUNT + 1];  // 각 타입별 우주비행사 수
-    int connected_routes[5];  // 최대 5개 연결 가능
-    int route_count;  // 현재 연결된 경로 수
-    bool has_teleporter;  // 텔레포터 유무
+    int astronaut_start;  // 착륙장: astronaut_types에서 입력 순서대로 저장된 도착 목록 시작 위치
+    int astronaut_total;  // 착륙장: 매달 도착하는 우주비행사 수
+    int tube_count;       // 연결된 튜브 수 (최대 5개)
+    int teleporter_exit;  // 텔레포터 입구면 출구 건물 인덱스, 아니면 -1
+    bool has_teleporter;  // 텔레포터 입구나 출구 유무
 } Building;
 
 // 경로 구조체
 typedef struct {
     int building1;
     int building2;
+    int index1;       // building1, building2의 건물 인덱스
+    int index2;
     int capacity;     // 0: 텔레포터, 1+: 튜브 용량
     double length;    // 길이 (비용 계산용)
 } Route;
@@ -39,53 +81,341 @@ typedef struct {
 // 포드 구조체
 typedef struct {
     int id;
-    int path[MAX_PATH];
+    int path[MAX_PATH];   // 정류장 건물 인덱스
     int path_length;
-    int current_pos;
-    bool is_moving;
 } Pod;
 
-// 우주비행사 구조체
+// 한 달 시뮬레이션 결과
 typedef struct {
-    int id;
-    int type;                // 1-20: 우주비행사 타입
-    int current_building;    // 현재 위치한 건물
-    int target_module;       // 목적지 모듈
-    int pod_id;              // 할당된 포드 ID (-1: 미할당)
-    int arrival_day;         // 착륙한 날짜
-    bool arrived;            // 목적지 도착 여부
-} Astronaut;
+    int score;
+    int speed_score;
+    int balance_score;
+    int arrived;      // 도착한 우주비행사 수
+    int stranded;     // 달이 끝날 때까지 도착하지 못한 우주비행사 수
+} MonthResult;
+
+// 출력 명령 (건물은 인덱스)
+typedef enum {
+    ACTION_TUBE,
+    ACTION_UPGRADE,
+    ACTION_TELEPORT,
+    ACTION_POD,
+    ACTION_DESTROY
+} ActionType;
+
+typedef struct {
+    ActionType type;
+    int building1;
+    int building2;
+    Pod pod;          // POD: 새 포드, DESTROY: 철거한 포드 (되돌리기용)
+    int cost;         // 적용할 때 계산한 비용 (철거는 음수)
+} Action;
+
+// 계획 후보 (명령 몇 개를 묶은 단위로 평가)
+typedef enum {
+    CANDIDATE_SHUTTLE,          // 기존 튜브 왕복 포드
+    CANDIDATE_UPGRADE_SHUTTLE,  // 튜브 업그레이드 + 왕복 포드
+    CANDIDATE_LINE,             // 없는 튜브를 지으며 정류장을 왕복하는 포드
+    CANDIDATE_TELEPORT,         // 착륙장 → 모듈 텔레포터
+    CANDIDATE_DESTROY,          // 포드 철거
+    CANDIDATE_RELOCATE          // 포드 철거 후 같은 자원으로 정류장을 왕복하는 새 포드
+} CandidateType;
+
+typedef struct {
+    CandidateType type;
+    int stops[MAX_LINE_STOPS];
+    int stop_count;
+    int pod_id;       // DESTROY, RELOCATE: 철거할 포드 ID
+    double ratio;     // 마지막 평가의 자원당 점수 증가 (-1: 불가능)
+} Candidate;
+
+// 착륙장에서 한 모듈 타입으로 가는 한 달 수요
+typedef struct {
+    int pad;
+    int type;
+    int count;
+} DemandFlow;
 
 // 전역 변수
 Building buildings[MAX_BUILDINGS];
 Route routes[MAX_TUBES];
-Pod pods[MAX_PODS];
-Astronaut astronauts[MAX_ASTRONAUTS];
+Pod pods[MAX_PODS];       // ID 오름차순 (이동 우선순위)
+char astronaut_types[MAX_ASTRONAUTS];
 int building_count = 0;
 int route_count = 0;
 int pod_count = 0;
-int astronaut_count = 0;
+int astronaut_type_total = 0;
 int month = 0;
-int current_day = 0;
-int total_score = 0;
-int buildings_with_arrivals[MAX_BUILDINGS];  // 이번 달에 도착한 우주비행사 수 기록
+
+// 건물 ID → 인덱스 해시 (선형 탐사, 값은 인덱스 + 1이고 0은 빈 칸)
+int building_id_hash[BUILDING_ID_HASH_SIZE];
+
+// 건물 인덱스 쌍 → 경로 인덱스 (-1: 경로 없음, 양방향 모두 기록)
+short route_between[MAX_BUILDINGS][MAX_BUILDINGS];
+
+// 균일 격자: 칸마다 그 안의 건물과 지나가는 튜브 연결 리스트 (튜브는 최근에 추가한 것이 앞)
+int grid_building_head[GRID_CELLS];
+int grid_building_next[MAX_BUILDINGS];
+int grid_tube_head[GRID_CELLS];
+short grid_tube_route[GRID_TUBE_ENTRIES];
+int grid_tube_next[GRID_TUBE_ENTRIES];
+int grid_tube_entry_count = 0;
+bool grid_ready = false;
+int tube_check_stamp[MAX_TUBES];    // 한 번의 검사에서 같은 튜브를 두 번 보지 않도록
+int tube_check_counter = 0;
+
+// 거리 전파용 역방향 CSR 인접 리스트: 건물 v로 들어오는 간선의 출발 건물과 튜브 수
+// (튜브는 양방향 가중치 1, 텔레포터는 출구에서 입구로 가중치 0)
+int adjacency_start[MAX_BUILDINGS + 1];
+int adjacency_source[2 * MAX_TUBES];
+char adjacency_weight[2 * MAX_TUBES];
+bool adjacency_dirty = false;
+
+// 건물에서 타입별 가장 가까운 모듈까지의 튜브 수 (텔레포터는 0), 경로나 모듈이 추가될 때만 갱신
+int type_distance[MAX_BUILDINGS][MODULE_TYPE_COUNT + 1];
+
+// 아직 거리 표에 반영하지 않은 경로와 모듈
+int pending_routes[MAX_TUBES];
+int pending_route_count = 0;
+int pending_modules[MAX_BUILDINGS];
+int pending_module_count = 0;
+
+// 매달 처음 출발하는 우주비행사 무리 (착륙장 ID 순, 착륙장 안에서는 입력 순서로 같은 타입끼리 묶음)
+int start_group_count = 0;
+bool start_groups_dirty = false;     // 새 착륙장이 들어온 달에만 다시 만듦
+short start_group_building[MAX_ASTRONAUTS];
+char start_group_type[MAX_ASTRONAUTS];
+short start_group_size[MAX_ASTRONAUTS];
+
+// 시뮬레이터 작업 공간: 무리는 우선순위 순서의 연결 리스트 (나뉜 무리는 원래 무리 바로 뒤에 삽입)
+short sim_group_building[MAX_SIM_GROUPS];
+char sim_group_type[MAX_SIM_GROUPS];
+short sim_group_size[MAX_SIM_GROUPS];
+short sim_group_moved_day[MAX_SIM_GROUPS];   // 이 날 이미 포드에 탄 무리는 다시 타지 않음
+int sim_group_next[MAX_SIM_GROUPS];
+short sim_pod_position[MAX_PODS];
+short sim_pod_seats[MAX_PODS];
+int sim_departure_head[MAX_BUILDINGS];       // 오늘 이 건물에서 출발하는 포드 (ID 순)
+int sim_departure_tail[MAX_BUILDINGS];
+int sim_departure_next[MAX_PODS];
+short sim_tube_day[MAX_TUBES];               // sim_tube_usage가 유효한 날
+short sim_tube_usage[MAX_TUBES];             // 오늘 튜브를 지나는 포드 수
+int sim_module_arrivals[MAX_BUILDINGS];      // 이번 달 모듈별 도착 수 (균형 점수)
+short sim_pod_route[MAX_PODS];               // 오늘 포드가 지나는 경로
+int sim_pod_riders[MAX_PODS];                // 이번 달 포드에 탄 연인원 (포드 위치 순)
+int sim_route_riders[MAX_TUBES];             // 이번 달 튜브를 지나간 연인원
+
+// 수요 흐름: 착륙장·타입별 인원을 최단 경로로 흘린 튜브별 통과 인원과 포드 좌석 수
+DemandFlow demand_flows[MAX_ASTRONAUTS];
+int demand_flow_count = 0;
+double route_load[MAX_TUBES];     // 한 달에 튜브를 지나는 우주비행사 수 (갈림길에서는 균등 분배)
+double route_seats[MAX_TUBES];    // 한 달에 포드가 튜브 한 방향으로 제공하는 좌석 수
+int route_pods[MAX_TUBES];        // 튜브를 지나는 포드 수
+double node_type_flow[MAX_BUILDINGS][MODULE_TYPE_COUNT + 1];  // 건물을 거쳐 가는 타입별 인원 (도달 불가면 착륙장에 남음)
+
+// 월간 계획 작업 공간
+Action plan_actions[MAX_PLAN_ACTIONS];
+int plan_action_count = 0;
+Candidate candidates[MAX_CANDIDATES];
+int candidate_count = 0;
+int committed_distance[MAX_BUILDINGS][MODULE_TYPE_COUNT + 1];  // 확정한 계획까지 반영한 거리 표
+int month_distance[MAX_BUILDINGS][MODULE_TYPE_COUNT + 1];      // 이번 달 입력 기준 거리 표
+// 계획 단계 (확정한 후보 하나): 비용, 한 달 점수 증가, 끝나는 plan_actions 위치
+int step_cost[MAX_PLAN_ACTIONS];
+int step_gain[MAX_PLAN_ACTIONS];
+int step_action_end[MAX_PLAN_ACTIONS];
+int step_count = 0;
+
+// 수입 모델: 입력 자원에서 지난달 남긴 자원과 이자를 뺀 값의 평균
+double expected_income = 0;
+int income_samples = 0;
+int resources_left = -1;      // 지난달 쓰고 남긴 자원 (-1: 첫 달)
+
+int tube_neighbors[MAX_BUILDINGS][TUBE_NEIGHBORS];
+int tube_neighbor_count[MAX_BUILDINGS];
+
+// ===== 프로파일링 (gcc -DSELENIA_PROFILE로 빌드할 때만, 기본 빌드에서는 매크로가 모두 비어 있음) =====
+// 단계별 시간과 현재 네트워크 점수의 튜브·포드·텔레포터별 기여를 모아 월간 요약 줄 끝에 덧붙임
+#ifdef SELENIA_PROFILE
+typedef enum {
+    PHASE_PARSE,
+    PHASE_DISTANCE,
+    PHASE_PLAN,         // 계획 중의 거리 갱신과 시뮬레이션 포함
+    PHASE_SIMULATION,
+    PHASE_COUNT
+} ProfilePhase;
+
+const char* profile_phase_names[PHASE_COUNT] = {"parse", "distance", "plan", "simulation"};
+double profile_ms[PHASE_COUNT];
+double profile_start_ms[PHASE_COUNT];
+int profile_calls[PHASE_COUNT];
+
+// 시뮬레이션 중 도착 점수를 마지막으로 태워 준 튜브, 포드, 텔레포터 입구에 기록
+int sim_route_points[MAX_TUBES];
+int sim_pod_points[MAX_PODS];
+int sim_teleport_points[MAX_BUILDINGS];
+
+// 이번 달 입력 네트워크 기준 기여 요약
+int attributed_tube_points, attributed_pod_points, attributed_teleport_points;
+int top_route, top_route_points, top_pod, top_pod_points;
+
+void profile_attribute();
+void profile_report();
+
+#define PROFILE_BEGIN(phase) (profile_start_ms[phase] = now_ms())
+#define PROFILE_END(phase) (profile_ms[phase] += now_ms() - profile_start_ms[phase], profile_calls[phase]++)
+#define PROFILE_POINTS(table, index, points) ((table)[index] += (points))
+#define PROFILE_ATTRIBUTE() profile_attribute()
+#define PROFILE_REPORT() profile_report()
+#else
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_POINTS(table, index, points) ((void)(points))
+#define PROFILE_ATTRIBUTE() ((void)0)
+#define PROFILE_REPORT() ((void)0)
+#endif
+
+// ===== 입출력 버퍼 (scanf/printf 대신 read/write로 모아서 처리) =====
+
+#define INPUT_BUFFER_SIZE (1 << 16)
+#define OUTPUT_BUFFER_SIZE (1 << 12)
+
+char input_buffer[INPUT_BUFFER_SIZE];
+int input_length = 0;
+int input_position = 0;
+char output_buffer[OUTPUT_BUFFER_SIZE];
+int output_length = 0;
+
+// 다음 바이트를 소비하지 않고 확인 (버퍼가 비면 다시 채우고, 입력이 끝났으면 -1)
+int peek_input() {
+    if (input_position == input_length) {
+        ssize_t count;
+        do {
+            count = read(STDIN_FILENO, input_buffer, sizeof(input_buffer));
+        } while (count < 0 && errno == EINTR);
+        input_position = 0;
+        input_length = count > 0 ? (int)count : 0;
+        if (count <= 0) {
+            return -1;
+        }
+    }
+    return (unsigned char)input_buffer[input_position];
+}
+
+// 부호 있는 정수 하나 읽기 (입력이 끝났으면 false)
+bool read_int(int* value) {
+    int c;
+    while ((c = peek_input()) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        input_position++;
+    }
+    bool negative = c == '-';
+    if (negative) {
+        input_position++;
+    }
+    c = peek_input();
+    if (c < '0' || c > '9') {
+        *value = 0;
+        return false;
+    }
+    int result = 0;
+    while ((c = peek_input()) >= '0' && c <= '9') {
+        result = result * 10 + (c - '0');
+        input_position++;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+// 모은 출력을 모두 내보내기 (턴마다 한 번)
+void flush_output() {
+    int written = 0;
+    while (written < output_length) {
+        ssize_t count = write(STDOUT_FILENO, output_buffer + written, output_length - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        written += (int)count;
+    }
+    output_length = 0;
+}
+
+void write_char(char c) {
+    if (output_length == OUTPUT_BUFFER_SIZE) {
+        flush_output();
+    }
+    output_buffer[output_length++] = c;
+}
+
+void write_string(const char* text) {
+    while (*text != '\0') {
+        write_char(*text++);
+    }
+}
+
+void write_int(int value) {
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    if (value < 0) {
+        write_char('-');
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        write_char(digits[--count]);
+    }
+}
 
 // 함수 선언
 double calculate_distance(int x1, int y1, int x2, int y2);
 bool point_on_segment(int ax, int ay, int bx, int by, int cx, int cy);
 bool segments_intersect(int ax, int ay, int bx, int by, int cx, int cy, int dx, int dy);
-bool can_build_tube(int building_id1, int building_id2);
+bool can_build_tube(int building_idx1, int building_idx2);
+void init_grid();
+int grid_cell(int x, int y);
+int collect_segment_cells(int ax, int ay, int bx, int by, int* cells);
+void grid_add_building(int building_idx);
+void grid_add_tube(int route_idx);
+void grid_remove_tube(int route_idx);
 int calculate_tube_cost(int building_id1, int building_id2);
-void parse_building_properties(char* properties);
-void parse_pod_properties(char* properties);
-void update_building_info(int id, int type, int x, int y);
-void execute_strategy(int resources);
+void parse_building_properties();
+void parse_pod_properties();
+int update_building_info(int id, int type, int x, int y);
+void execute_strategy(int resources, double deadline_ms);
 int find_building_index(int id);
-void simulate_astronaut_movement();
-int calculate_distance_to_target(int building_id, int target_type);
-void calculate_scores();
-void apply_interest(int* resources);
-void initialize_monthly_data();
+int add_route(int building_idx1, int building_idx2, int capacity);
+void rebuild_adjacency();
+void update_distances();
+void sort_pods();
+void prepare_start_groups();
+void add_pad_demand(int pad);
+void route_demand_flows();
+void count_pod_seats();
+void add_teleport_candidates();
+void simulate_month(MonthResult* result);
+double now_ms();
+void remove_last_route();
+void insert_pod(const Pod* pod);
+bool remove_pod(int pod_id, Pod* removed);
+int next_pod_id();
+bool apply_action(Action* action);
+void undo_action(const Action* action);
+int expand_candidate(const Candidate* candidate, Action* actions);
+int evaluate_candidate(const Candidate* candidate, int budget, int* cost);
+Candidate* add_candidate(CandidateType type, const int* stops, int stop_count, double ratio);
+int extend_loop(int* stops, int stop_count, const double* unmet, bool* visited);
+void add_loop_candidates();
+void collect_tube_neighbors();
+void add_line_candidates(int pad);
+void generate_candidates(int budget);
+void write_action(const Action* action);
+int plan_greedy(int* budget, int* base_score, double deadline_ms, int* evaluations);
+double schedule_value(int prefix, int resources, int months_left);
 
 // 두 점 사이의 거리 계산
 double calculate_distance(int x1, int y1, int x2, int y2) {
@@ -118,39 +448,118 @@ bool segments_intersect(int ax, int ay, int bx, int by, int cx, int cy, int dx,
     return (o1 * o2 < 0 && o3 * o4 < 0);
 }
 
-// 튜브 건설 가능 여부 확인
-bool can_build_tube(int building_id1, int building_id2) {
-    Building *b1 = &buildings[building_id1];
-    Building *b2 = &buildings[building_id2];
+// 격자 초기화 (첫 건물을 추가하기 전에 한 번)
+void init_grid() {
+    memset(grid_building_head, -1, sizeof(grid_building_head));
+    memset(grid_tube_head, -1, sizeof(grid_tube_head));
+    grid_tube_entry_count = 0;
+    grid_ready = true;
+}
+
+int grid_cell(int x, int y) {
+    return (y / GRID_CELL_SIZE) * GRID_COLUMNS + x / GRID_CELL_SIZE;
+}
+
+// 선분이 닿는 칸 목록 (열마다 선분의 y 범위에 걸친 칸, 경계 위의 점도 양쪽 칸에 포함)
+int collect_segment_cells(int ax, int ay, int bx, int by, int* cells) {
+    if (ax > bx) {
+        int swap = ax; ax = bx; bx = swap;
+        swap = ay; ay = by; by = swap;
+    }
+    int count = 0;
+    double slope = ax == bx ? 0 : (double)(by - ay) / (bx - ax);
+    for (int column = ax / GRID_CELL_SIZE; column <= bx / GRID_CELL_SIZE; column++) {
+        double y_low, y_high;
+        if (ax == bx) {
+            y_low = ay < by ? ay : by;
+            y_high = ay < by ? by : ay;
+        } else {
+            int left = column * GRID_CELL_SIZE > ax ? column * GRID_CELL_SIZE : ax;
+            int right = (column + 1) * GRID_CELL_SIZE < bx ? (column + 1) * GRID_CELL_SIZE : bx;
+            double y_left = ay + slope * (left - ax);
+            double y_right = ay + slope * (right - ax);
+            y_low = (y_left < y_right ? y_left : y_right) - 1e-6;
+            y_high = (y_left < y_right ? y_right : y_left) + 1e-6;
+        }
+        int row_low = y_low < 0 ? 0 : (int)(y_low / GRID_CELL_SIZE);
+        int row_high = (int)(y_high / GRID_CELL_SIZE);
+        if (row_high >= GRID_ROWS) {
+            row_high = GRID_ROWS - 1;
+        }
+        for (int row = row_low; row <= row_high; row++) {
+            cells[count++] = row * GRID_COLUMNS + column;
+        }
+    }
+    return count;
+}
+
+void grid_add_building(int building_idx) {
+    int cell = grid_cell(buildings[building_idx].x, buildings[building_idx].y);
+    grid_building_next[building_idx] = grid_building_head[cell];
+    grid_building_head[cell] = building_idx;
+}
+
+void grid_add_tube(int route_idx) {
+    const Building* b1 = &buildings[routes[route_idx].index1];
+    const Building* b2 = &buildings[routes[route_idx].index2];
+    int cells[GRID_CELLS];
+    int cell_count = collect_segment_cells(b1->x, b1->y, b2->x, b2->y, cells);
+    for (int i = 0; i < cell_count; i++) {
+        int entry = grid_tube_entry_count++;
+        grid_tube_route[entry] = route_idx;
+        grid_tube_next[entry] = grid_tube_head[cells[i]];
+        grid_tube_head[cells[i]] = entry;
+    }
+}
+
+// 가장 최근에 추가한 튜브 제거 (칸마다 맨 앞에 있음)
+void grid_remove_tube(int route_idx) {
+    const Building* b1 = &buildings[routes[route_idx].index1];
+    const Building* b2 = &buildings[routes[route_idx].index2];
+    int cells[GRID_CELLS];
+    int cell_count = collect_segment_cells(b1->x, b1->y, b2->x, b2->y, cells);
+    for (int i = 0; i < cell_count; i++) {
+        grid_tube_head[cells[i]] = grid_tube_next[grid_tube_head[cells[i]]];
+    }
+    grid_tube_entry_count -= cell_count;
+}
+
+// 튜브 건설 가능 여부 확인 (건물 인덱스, 선분이 지나는 격자 칸의 건물과 튜브만 검사)
+bool can_build_tube(int building_idx1, int building_idx2) {
+    Building *b1 = &buildings[building_idx1];
+    Building *b2 = &buildings[building_idx2];
     
     // 각 건물이 이미 5개의 연결을 가지고 있는지 확인
-    if (b1->route_count >= 5 || b2->route_count >= 5) {
+    if (b1->tube_count >= MAX_TUBES_PER_BUILDING || b2->tube_count >= MAX_TUBES_PER_BUILDING) {
         return false;
     }
     
     // 두 건물 사이에 이미 튜브가 있는지 확인
-    for (int i = 0; i < route_count; i++) {
-        if ((routes[i].building1 == building_id1 && routes[i].building2 == building_id2) ||
-            (routes[i].building1 == building_id2 && routes[i].building2 == building_id1)) {
-            return false;
-        }
+    if (route_between[building_idx1][building_idx2] != -1) {
+        return false;
     }
     
-    // 다른 건물이 경로 상에 있는지 확인
-    for (int i = 0; i < building_count; i++) {
-        if (i != building_id1 && i != building_id2) {
-            if (point_on_segment(buildings[i].x, buildings[i].y, b1->x, b1->y, b2->x, b2->y)) {
+    int cells[GRID_CELLS];
+    int cell_count = collect_segment_cells(b1->x, b1->y, b2->x, b2->y, cells);
+    tube_check_counter++;
+    for (int c = 0; c < cell_count; c++) {
+        // 다른 건물이 경로 상에 있는지 확인
+        for (int i = grid_building_head[cells[c]]; i != -1; i = grid_building_next[i]) {
+            if (i != building_idx1 && i != building_idx2 &&
+                point_on_segment(buildings[i].x, buildings[i].y, b1->x, b1->y, b2->x, b2->y)) {
                 return false;
             }
         }
-    }
-    
-    // 다른 튜브와 교차하는지 확인
-    for (int i = 0; i < route_count; i++) {
-        if (routes[i].capacity > 0) { // 튜브만 확인
-            Building *rb1 = &buildings[routes[i].building1];
-            Building *rb2 = &buildings[routes[i].building2];
-            
+        
+        // 다른 튜브와 교차하는지 확인
+        for (int e = grid_tube_head[cells[c]]; e != -1; e = grid_tube_next[e]) {
+            int r = grid_tube_route[e];
+            if (tube_check_stamp[r] == tube_check_counter) {
+                continue;
+            }
+            tube_check_stamp[r] = tube_check_counter;
+            Building *rb1 = &buildings[routes[r].index1];
+            Building *rb2 = &buildings[routes[r].index2];
             if (segments_intersect(b1->x, b1->y, b2->x, b2->y, rb1->x, rb1->y, rb2->x, rb2->y)) {
                 return false;
             }
@@ -173,64 +582,197 @@ int calculate_tube_cost(int building_id1, int building_id2) {
                                         buildings[b2_idx].x, buildings[b2_idx].y);
     
     // 0.1km당 1 자원, 내림
-    return (int)(distance / 100);
+    return (int)(distance * 10);
 }
 
-// 건물 ID로 인덱스를 찾는 함수 추가
+// 건물 ID로 인덱스 찾기 (해시 조회)
 int find_building_index(int id) {
-    for (int i = 0; i < building_count; i++) {
-        if (buildings[i].id == id) {
-            return i;
+    unsigned int slot = ((unsigned int)id * 2654435761u) & (BUILDING_ID_HASH_SIZE - 1);
+    while (building_id_hash[slot] != 0) {
+        int idx = building_id_hash[slot] - 1;
+        if (buildings[idx].id == id) {
+            return idx;
         }
+        slot = (slot + 1) & (BUILDING_ID_HASH_SIZE - 1);
     }
     return -1; // 건물을 찾지 못함
 }
 
-// 건물 정보 파싱
-void parse_building_properties(char* properties) {
-    int values[504]; // 최대 500 astronauts + 4 parameters
-    char* token = strtok(properties, " ");
-    int count = 0;
+// 새 경로 등록 (튜브 수, 텔레포터 정보, 인덱스 쌍 표 갱신 후 거리 갱신 대기열에 추가)
+int add_route(int building_idx1, int building_idx2, int capacity) {
+    int route_idx = route_count++;
+    Route* route = &routes[route_idx];
+    route->building1 = buildings[building_idx1].id;
+    route->building2 = buildings[building_idx2].id;
+    route->index1 = building_idx1;
+    route->index2 = building_idx2;
+    route->capacity = capacity;
+    route->length = calculate_distance(buildings[building_idx1].x, buildings[building_idx1].y,
+                                       buildings[building_idx2].x, buildings[building_idx2].y);
+    
+    route_between[building_idx1][building_idx2] = route_idx;
+    route_between[building_idx2][building_idx1] = route_idx;
+    if (capacity == 0) {
+        // 텔레포터는 building1이 입구, building2가 출구
+        buildings[building_idx1].teleporter_exit = building_idx2;
+        buildings[building_idx1].has_teleporter = true;
+        buildings[building_idx2].has_teleporter = true;
+    } else {
+        buildings[building_idx1].tube_count++;
+        buildings[building_idx2].tube_count++;
+        grid_add_tube(route_idx);
+    }
+    
+    pending_routes[pending_route_count++] = route_idx;
+    adjacency_dirty = true;
+    return route_idx;
+}
+
+// 역방향 CSR 인접 리스트 재구성 (경로가 추가된 달에만)
+void rebuild_adjacency() {
+    int degree[MAX_BUILDINGS + 1] = {0};
+    for (int r = 0; r < route_count; r++) {
+        int idx1 = routes[r].index1;
+        int idx2 = routes[r].index2;
+        if (routes[r].capacity == 0) {
+            degree[idx2]++;
+        } else {
+            degree[idx1]++;
+            degree[idx2]++;
+        }
+    }
+    
+    adjacency_start[0] = 0;
+    for (int i = 0; i < building_count; i++) {
+        adjacency_start[i + 1] = adjacency_start[i] + degree[i];
+        degree[i] = adjacency_start[i];
+    }
     
-    while (token != NULL && count < 504) {
-        values[count++] = atoi(token);
-        token = strtok(NULL, " ");
+    for (int r = 0; r < route_count; r++) {
+        int idx1 = routes[r].index1;
+        int idx2 = routes[r].index2;
+        if (routes[r].capacity == 0) {
+            // 출구의 거리가 줄면 입구의 거리도 같이 줄어듦
+            adjacency_source[degree[idx2]] = idx1;
+            adjacency_weight[degree[idx2]++] = 0;
+        } else {
+            adjacency_source[degree[idx1]] = idx2;
+            adjacency_weight[degree[idx1]++] = 1;
+            adjacency_source[degree[idx2]] = idx1;
+            adjacency_weight[degree[idx2]++] = 1;
+        }
+    }
+    adjacency_dirty = false;
+}
+
+// 거리 표 증분 갱신: 경로와 모듈은 추가만 되므로 거리는 줄어들기만 함
+// 새 모듈과 새 경로 양 끝에서 줄어든 거리만 역방향 간선을 따라 전파
+void update_distances() {
+    if (adjacency_dirty) {
+        rebuild_adjacency();
+    }
+    if (pending_route_count == 0 && pending_module_count == 0) {
+        return;
     }
+    PROFILE_BEGIN(PHASE_DISTANCE);
     
-    int type = values[0];
-    int id = values[1];
-    int x = values[2];
-    int y = values[3];
+    int queue[MAX_BUILDINGS];
+    bool queued[MAX_BUILDINGS];
+    for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
+        int head = 0, size = 0;
+        memset(queued, 0, sizeof(bool) * building_count);
+        
+        for (int i = 0; i < pending_module_count; i++) {
+            int m = pending_modules[i];
+            if (buildings[m].type == type && type_distance[m][type] > 0) {
+                type_distance[m][type] = 0;
+                queue[(head + size++) % MAX_BUILDINGS] = m;
+                queued[m] = true;
+            }
+        }
+        
+        for (int i = 0; i < pending_route_count; i++) {
+            const Route* route = &routes[pending_routes[i]];
+            int idx1 = route->index1;
+            int idx2 = route->index2;
+            int weight = route->capacity == 0 ? 0 : 1;
+            
+            // 텔레포터는 입구(idx1) 쪽으로만, 튜브는 양쪽으로 완화
+            for (int side = 0; side < (weight == 0 ? 1 : 2); side++) {
+                int from = side == 0 ? idx2 : idx1;
+                int to = side == 0 ? idx1 : idx2;
+                int candidate = type_distance[from][type] + weight;
+                if (candidate < type_distance[to][type]) {
+                    type_distance[to][type] = candidate;
+                    if (!queued[to]) {
+                        queue[(head + size++) % MAX_BUILDINGS] = to;
+                        queued[to] = true;
+                    }
+                }
+            }
+        }
+        
+        // 줄어든 거리를 들어오는 간선의 출발 건물로 전파 (큐에는 건물당 한 번만)
+        while (size > 0) {
+            int current = queue[head];
+            head = (head + 1) % MAX_BUILDINGS;
+            size--;
+            queued[current] = false;
+            
+            int current_distance = type_distance[current][type];
+            for (int e = adjacency_start[current]; e < adjacency_start[current + 1]; e++) {
+                int source = adjacency_source[e];
+                int candidate = current_distance + adjacency_weight[e];
+                if (candidate < type_distance[source][type]) {
+                    type_distance[source][type] = candidate;
+                    if (!queued[source]) {
+                        queue[(head + size++) % MAX_BUILDINGS] = source;
+                        queued[source] = true;
+                    }
+                }
+            }
+        }
+    }
+    
+    pending_route_count = 0;
+    pending_module_count = 0;
+    PROFILE_END(PHASE_DISTANCE);
+}
+
+// 건물 정보 파싱 (입력 버퍼에서 한 줄 분량을 바로 읽어 건물 표, 도착 목록, 수요 표에 곧장 기록)
+void parse_building_properties() {
+    int type, id, x, y;
+    read_int(&type);
+    read_int(&id);
+    read_int(&x);
+    read_int(&y);
     
     // 새 건물 정보 업데이트
-    update_building_info(id, type, x, y);
+    int building_idx = update_building_info(id, type, x, y);
     
     // 착륙장이라면 우주비행사 정보도 저장
     if (type == LANDING_PAD) {
-        int astronaut_count = values[4];
-        int building_idx = find_building_index(id);
-        if (building_idx != -1) {
-            for (int i = 0; i < astronaut_count && i + 5 < count; i++) {
-                int astronaut_type = values[i + 5];
+        int astronaut_count;
+        read_int(&astronaut_count);
+        buildings[building_idx].astronaut_start = astronaut_type_total;
+        for (int i = 0; i < astronaut_count; i++) {
+            int astronaut_type;
+            read_int(&astronaut_type);
+            if (astronaut_type >= 1 && astronaut_type <= MODULE_TYPE_COUNT && astronaut_type_total < MAX_ASTRONAUTS) {
                 buildings[building_idx].astronaut_count[astronaut_type]++;
+                astronaut_types[astronaut_type_total++] = (char)astronaut_type;
             }
         }
+        buildings[building_idx].astronaut_total = astronaut_type_total - buildings[building_idx].astronaut_start;
+        add_pad_demand(building_idx);
     }
 }
 
-// 포드 정보 파싱
-void parse_pod_properties(char* properties) {
-    int values[MAX_PATH + 2]; // id + path_length + path
-    char* token = strtok(properties, " ");
-    int count = 0;
-    
-    while (token != NULL && count < MAX_PATH + 2) {
-        values[count++] = atoi(token);
-        token = strtok(NULL, " ");
-    }
-    
-    int pod_id = values[0];
-    int path_length = values[1];
+// 포드 정보 파싱 (입력 버퍼에서 한 줄 분량을 바로 읽음)
+void parse_pod_properties() {
+    int pod_id, path_length;
+    read_int(&pod_id);
+    read_int(&path_length);
     
     // 포드 정보 업데이트
     Pod* pod = NULL;
@@ -249,660 +791,1298 @@ void parse_pod_properties(char* properties) {
         pod->id = pod_id;
     }
     
-    pod->path_length = path_length;
-    for (int i = 0; i < path_length && i + 2 < count; i++) {
-        pod->path[i] = values[i + 2];
+    // 정류장은 건물 인덱스로 저장, MAX_PATH를 넘는 정류장은 읽고 버림
+    pod->path_length = path_length < MAX_PATH ? path_length : MAX_PATH;
+    for (int i = 0; i < path_length; i++) {
+        int stop;
+        read_int(&stop);
+        if (i < MAX_PATH) {
+            pod->path[i] = find_building_index(stop);
+        }
     }
-    pod->current_pos = 0;
-    pod->is_moving = true;
 }
 
 // 건물 정보 업데이트
-void update_building_info(int id, int type, int x, int y) {
-    // ID가 이미 존재하는지 확인
-    for (int i = 0; i < building_count; i++) {
-        if (buildings[i].id == id) {
-            // 기존 건물 정보 업데이트
-            buildings[i].type = type;
-            buildings[i].x = x;
-            buildings[i].y = y;
-            return;
-        }
+int update_building_info(int id, int type, int x, int y) {
+    // ID가 이미 존재하면 기존 건물 정보 업데이트
+    int existing = find_building_index(id);
+    if (existing != -1) {
+        buildings[existing].type = type;
+        buildings[existing].x = x;
+        buildings[existing].y = y;
+        return existing;
     }
     
     // 새 건물 추가
-    Building* building = &buildings[building_count++];
+    if (!grid_ready) {
+        init_grid();
+    }
+    int idx = building_count++;
+    Building* building = &buildings[idx];
     building->id = id;
     building->type = type;
     building->x = x;
     building->y = y;
-    building->route_count = 0;
+    building->astronaut_start = 0;
+    building->astronaut_total = 0;
+    building->tube_count = 0;
+    building->teleporter_exit = -1;
     building->has_teleporter = false;
     
     for (int i = 0; i <= MODULE_TYPE_COUNT; i++) {
         building->astronaut_count[i] = 0;
+        type_distance[idx][i] = UNREACHABLE;
+    }
+    for (int i = 0; i < building_count; i++) {
+        route_between[idx][i] = -1;
+        route_between[i][idx] = -1;
+    }
+    
+    unsigned int slot = ((unsigned int)id * 2654435761u) & (BUILDING_ID_HASH_SIZE - 1);
+    while (building_id_hash[slot] != 0) {
+        slot = (slot + 1) & (BUILDING_ID_HASH_SIZE - 1);
     }
+    building_id_hash[slot] = idx + 1;
+    grid_add_building(idx);
+    
+    if (type != LANDING_PAD) {
+        pending_modules[pending_module_count++] = idx;
+    }
+    return idx;
 }
 
-// 건물 간의 최단 거리 계산 (BFS 알고리즘)
-int calculate_distance_to_target(int building_id, int target_type) {
-    int queue[MAX_BUILDINGS];
-    int distance[MAX_BUILDINGS];
-    bool visited[MAX_BUILDINGS];
-    int front = 0, rear = 0;
-    
-    // 초기화
+// 포드를 ID 오름차순으로 정렬 (튜브 혼잡 시 작은 ID 우선)
+void sort_pods() {
+    for (int i = 1; i < pod_count; i++) {
+        Pod pod = pods[i];
+        int j = i - 1;
+        while (j >= 0 && pods[j].id > pod.id) {
+            pods[j + 1] = pods[j];
+            j--;
+        }
+        pods[j + 1] = pod;
+    }
+}
+
+// 이번 달 출발 무리 구성: 작은 ID의 착륙장부터, 착륙장 안에서는 입력 순서대로 연속한 같은 타입을 묶음
+void prepare_start_groups() {
+    int order[MAX_BUILDINGS];
+    int pad_count = 0;
     for (int i = 0; i < building_count; i++) {
-        distance[i] = -1;
-        visited[i] = false;
+        if (buildings[i].type != LANDING_PAD) {
+            continue;
+        }
+        int j = pad_count++;
+        while (j > 0 && buildings[order[j - 1]].id > buildings[i].id) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
     }
     
-    // 시작 건물 큐에 추가
-    int start_idx = find_building_index(building_id);
-    if (start_idx == -1) return -1;
-    
-    queue[rear++] = start_idx;
-    distance[start_idx] = 0;
-    visited[start_idx] = true;
+    start_group_count = 0;
+    for (int p = 0; p < pad_count; p++) {
+        const Building* pad = &buildings[order[p]];
+        for (int i = 0; i < pad->astronaut_total; i++) {
+            int type = astronaut_types[pad->astronaut_start + i];
+            int last = start_group_count - 1;
+            if (i > 0 && start_group_type[last] == type) {
+                start_group_size[last]++;
+            } else {
+                start_group_building[start_group_count] = order[p];
+                start_group_type[start_group_count] = (char)type;
+                start_group_size[start_group_count] = 1;
+                start_group_count++;
+            }
+        }
+    }
+}
+
+// 새 착륙장의 타입별 인원을 수요 표에 추가하고 출발 무리를 다시 만들도록 표시
+void add_pad_demand(int pad) {
+    for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
+        if (buildings[pad].astronaut_count[type] > 0) {
+            DemandFlow* flow = &demand_flows[demand_flow_count++];
+            flow->pad = pad;
+            flow->type = type;
+            flow->count = buildings[pad].astronaut_count[type];
+        }
+    }
+    start_groups_dirty = true;
+}
+
+// 수요를 거리 표를 따라 흘려 튜브별 통과 인원 계산 (거리 표와 인접 리스트가 최신이어야 함)
+// 우주비행사는 거리가 줄어드는 튜브만 타므로 거리가 먼 건물부터 처리하면 한 번에 끝남
+// 텔레포터는 출구의 거리가 같을 때만 타므로 같은 거리에서는 텔레포터 입구를 먼저 처리
+void route_demand_flows() {
+    memset(route_load, 0, sizeof(double) * route_count);
+    memset(node_type_flow, 0, sizeof(node_type_flow[0]) * building_count);
+    double node_flow[MAX_BUILDINGS];
+    int order[MAX_BUILDINGS];
+    int bucket_start[MAX_BUILDINGS + 2];
     
-    // BFS 탐색
-    while (front < rear) {
-        int current = queue[front++];
+    for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
+        bool demanded = false;
+        memset(node_flow, 0, sizeof(double) * building_count);
+        for (int f = 0; f < demand_flow_count; f++) {
+            if (demand_flows[f].type == type) {
+                node_flow[demand_flows[f].pad] += demand_flows[f].count;
+                demanded = true;
+            }
+        }
+        if (!demanded) {
+            continue;
+        }
         
-        // 타겟 타입 도달 확인
-        if (buildings[current].type == target_type) {
-            return distance[current];
+        // 거리별 계수 정렬 (먼 거리 먼저, 같은 거리에서는 텔레포터 입구 먼저), 도달 불가는 제외
+        memset(bucket_start, 0, sizeof(int) * (building_count + 2));
+        for (int i = 0; i < building_count; i++) {
+            int distance = type_distance[i][type];
+            if (distance < building_count) {
+                bucket_start[building_count - distance]++;
+            }
+        }
+        for (int d = 1; d <= building_count + 1; d++) {
+            bucket_start[d] += bucket_start[d - 1];
+        }
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 0; i < building_count; i++) {
+                int distance = type_distance[i][type];
+                bool entrance = buildings[i].teleporter_exit != -1;
+                if (distance < building_count && entrance == (pass == 0)) {
+                    order[bucket_start[building_count - distance - 1]++] = i;
+                }
+            }
         }
+        int ordered = bucket_start[building_count];
         
-        // 연결된 모든 경로 탐색
-        for (int i = 0; i < buildings[current].route_count; i++) {
-            int route_idx = buildings[current].connected_routes[i];
-            int next_building;
-            
-            if (routes[route_idx].building1 == buildings[current].id) {
-                next_building = find_building_index(routes[route_idx].building2);
-            } else {
-                next_building = find_building_index(routes[route_idx].building1);
+        for (int k = 0; k < ordered; k++) {
+            int current = order[k];
+            double flow = node_flow[current];
+            if (flow == 0 || buildings[current].type == type) {
+                continue;
+            }
+            int exit = buildings[current].teleporter_exit;
+            if (exit != -1 && type_distance[exit][type] <= type_distance[current][type]) {
+                node_flow[exit] += flow;
+                continue;
             }
             
-            // 텔레포터는 무시하지 않고 길이 0으로 처리
-            if (!visited[next_building]) {
-                visited[next_building] = true;
-                
-                // 텔레포터인 경우 거리 증가 없음
-                if (routes[route_idx].capacity == 0) {
-                    distance[next_building] = distance[current];
-                } else {
-                    distance[next_building] = distance[current] + 1;
+            // 더 가까운 이웃으로 균등 분배 (튜브는 양방향이라 역방향 인접 리스트로 충분)
+            int closer = 0;
+            int next_distance = type_distance[current][type] - 1;
+            for (int e = adjacency_start[current]; e < adjacency_start[current + 1]; e++) {
+                closer += adjacency_weight[e] == 1 && type_distance[adjacency_source[e]][type] == next_distance;
+            }
+            for (int e = adjacency_start[current]; e < adjacency_start[current + 1]; e++) {
+                int neighbor = adjacency_source[e];
+                if (adjacency_weight[e] == 1 && type_distance[neighbor][type] == next_distance) {
+                    node_flow[neighbor] += flow / closer;
+                    route_load[route_between[current][neighbor]] += flow / closer;
                 }
-                
-                queue[rear++] = next_building;
             }
         }
+        for (int i = 0; i < building_count; i++) {
+            node_type_flow[i][type] = node_flow[i];
+        }
     }
-    
-    return -1;  // 경로 없음
 }
 
-// 이동 시뮬레이션 - 4단계 이동 로직
-void simulate_astronaut_movement() {
-    // 매일 20일 동안 이동 시뮬레이션
-    for (current_day = 0; current_day < 20; current_day++) {
-        fprintf(stderr, "Simulating day %d\n", current_day);
-        
-        // 1단계: 텔레포터 이동
-        for (int i = 0; i < astronaut_count; i++) {
-            if (astronauts[i].arrived) continue;
-            
-            int current_building_idx = find_building_index(astronauts[i].current_building);
-            if (current_building_idx == -1) continue;
-            
-            // 각 건물에서 가능한 텔레포터 확인
-            for (int r = 0; r < buildings[current_building_idx].route_count; r++) {
-                int route_idx = buildings[current_building_idx].connected_routes[r];
-                
-                // 텔레포터인지 확인
-                if (routes[route_idx].capacity == 0) {
-                    int exit_building_id;
-                    
-                    // 텔레포터 출구 찾기
-                    if (routes[route_idx].building1 == astronauts[i].current_building) {
-                        exit_building_id = routes[route_idx].building2;
-                    } else {
-                        exit_building_id = routes[route_idx].building1;
-                    }
-                    
-                    // 텔레포터 출구 건물의 목적지까지 거리 확인
-                    int current_dist = calculate_distance_to_target(astronauts[i].current_building, astronauts[i].type);
-                    int exit_dist = calculate_distance_to_target(exit_building_id, astronauts[i].type);
-                    
-                    // 출구가 목적지에 가깝거나 같은 거리이면 텔레포트
-                    if (exit_dist != -1 && (current_dist == -1 || exit_dist <= current_dist)) {
-                        astronauts[i].current_building = exit_building_id;
-                        fprintf(stderr, "Astronaut %d teleported to building %d\n", i, exit_building_id);
-                        
-                        // 텔레포트 후 목적지 도착 확인
-                        int exit_building_idx = find_building_index(exit_building_id);
-                        if (exit_building_idx != -1 && buildings[exit_building_idx].type == astronauts[i].type) {
-                            astronauts[i].arrived = true;
-                            buildings_with_arrivals[exit_building_idx]++;
-                            fprintf(stderr, "Astronaut %d arrived at destination!\n", i);
-                        }
-                        break;
-                    }
-                }
-            }
+// 포드별로 지나는 튜브의 한 달 좌석 수 합산 (순환 포드는 한 바퀴를 여러 번 돎)
+void count_pod_seats() {
+    memset(route_seats, 0, sizeof(double) * route_count);
+    memset(route_pods, 0, sizeof(int) * route_count);
+    for (int p = 0; p < pod_count; p++) {
+        const Pod* pod = &pods[p];
+        int hops = pod->path_length - 1;
+        if (hops < 1) {
+            continue;
         }
-        
-        // 2단계: 포드 할당 - 튜브 용량 고려
-        for (int i = 0; i < pod_count; i++) {
-            pods[i].is_moving = false;
+        bool loop = pod->path[0] == pod->path[hops];
+        double seats = loop ? (double)POD_CAPACITY * MONTH_DAYS / hops / 2 : POD_CAPACITY;
+        for (int i = 0; i < hops; i++) {
+            int route = route_between[pod->path[i]][pod->path[i + 1]];
+            if (route != -1) {
+                route_seats[route] += seats;
+                route_pods[route]++;
+            }
         }
-        
-        int pods_on_tubes[MAX_TUBES] = {0};  // 각 튜브에 할당된 포드 수
-        
-        // 포드 ID 순으로 정렬해서 우선권 부여
-        for (int i = 0; i < pod_count; i++) {
-            // 현재 포드 위치 확인
-            if (pods[i].current_pos >= pods[i].path_length - 1) {
-                // 루프가 아니면 멈춤
-                if (pods[i].path[0] != pods[i].path[pods[i].path_length - 1]) {
-                    continue;
+    }
+}
+
+// 무리 도착 처리: 속도 점수는 걸린 날 수, 균형 점수는 이번 달 먼저 도착한 수만큼 차감
+static inline int sim_arrive(MonthResult* result, int group, int module, int days) {
+    int size = sim_group_size[group];
+    int earlier = sim_module_arrivals[module];
+    int balanced = BALANCE_POINTS - earlier;
+    if (balanced > size) {
+        balanced = size;
+    }
+    int balance = 0;
+    if (balanced > 0) {
+        // 50 - earlier, 49 - earlier, ... 을 balanced개 더한 값
+        balance = balanced * (BALANCE_POINTS - earlier) - balanced * (balanced - 1) / 2;
+    }
+    result->speed_score += size * (SPEED_POINTS - days);
+    result->balance_score += balance;
+    result->arrived += size;
+    sim_module_arrivals[module] += size;
+    sim_group_building[group] = -1;
+    return size * (SPEED_POINTS - days) + balance;
+}
+
+// 현재 네트워크(경로, 텔레포터, 거리 표, 포드)로 한 달 20일을 심판 규칙대로 시뮬레이션
+// 하루는 텔레포터 → 튜브에 포드 배정 → 우주비행사 탑승 → 포드 출발 순서
+// 탑승은 시작과 동시에 목적지로 옮겨 처리하고, 그날 다시 움직이지 않도록 표시
+void simulate_month(MonthResult* result) {
+    memset(result, 0, sizeof(*result));
+    memset(sim_module_arrivals, 0, sizeof(int) * building_count);
+    memset(sim_tube_day, -1, sizeof(short) * route_count);
+    memset(sim_route_riders, 0, sizeof(int) * route_count);
+    memset(sim_pod_riders, 0, sizeof(int) * pod_count);
+#ifdef SELENIA_PROFILE
+    PROFILE_BEGIN(PHASE_SIMULATION);
+    memset(sim_route_points, 0, sizeof(int) * route_count);
+    memset(sim_pod_points, 0, sizeof(int) * pod_count);
+    memset(sim_teleport_points, 0, sizeof(int) * building_count);
+#endif
+    for (int b = 0; b < building_count; b++) {
+        sim_departure_head[b] = -1;
+    }
+    
+    int group_count = start_group_count;
+    for (int g = 0; g < group_count; g++) {
+        sim_group_building[g] = start_group_building[g];
+        sim_group_type[g] = start_group_type[g];
+        sim_group_size[g] = start_group_size[g];
+        sim_group_moved_day[g] = -1;
+        sim_group_next[g] = g + 1;
+    }
+    int head = group_count > 0 ? 0 : -1;
+    if (group_count > 0) {
+        sim_group_next[group_count - 1] = -1;
+    }
+    for (int p = 0; p < pod_count; p++) {
+        sim_pod_position[p] = 0;
+    }
+    
+    for (int day = 0; day < MONTH_DAYS && head != -1; day++) {
+        // 1단계: 텔레포터 (출구의 거리가 입구보다 크지 않으면 이동), 도착한 무리는 목록에서 제거
+        int previous = -1;
+        for (int g = head; g != -1; g = sim_group_next[g]) {
+            int building = sim_group_building[g];
+            if (building < 0) {
+                if (previous == -1) {
+                    head = sim_group_next[g];
+                } else {
+                    sim_group_next[previous] = sim_group_next[g];
                 }
-                pods[i].current_pos = 0;  // 루프 시작으로 리셋
+                continue;
             }
+            previous = g;
             
-            int current_building = pods[i].path[pods[i].current_pos];
-            int next_building = pods[i].path[pods[i].current_pos + 1];
-            
-            // 해당 건물 사이의 튜브 찾기
-            for (int r = 0; r < route_count; r++) {
-                if ((routes[r].building1 == current_building && routes[r].building2 == next_building) ||
-                    (routes[r].building2 == current_building && routes[r].building1 == next_building)) {
-                    
-                    // 텔레포터는 용량 제한 없음
-                    if (routes[r].capacity == 0) {
-                        pods[i].is_moving = true;
-                        break;
-                    }
-                    
-                    // 튜브 용량 확인
-                    if (pods_on_tubes[r] < routes[r].capacity) {
-                        pods[i].is_moving = true;
-                        pods_on_tubes[r]++;
-                        break;
-                    }
+            int exit = buildings[building].teleporter_exit;
+            int type = sim_group_type[g];
+            if (exit != -1 && type_distance[exit][type] <= type_distance[building][type]) {
+                sim_group_building[g] = exit;
+                if (buildings[exit].type == type) {
+                    int points = sim_arrive(result, g, exit, day);
+                    PROFILE_POINTS(sim_teleport_points, building, points);
                 }
             }
         }
         
-        // 3단계: 우주비행사 할당
-        for (int i = 0; i < astronaut_count; i++) {
-            if (astronauts[i].arrived || astronauts[i].pod_id != -1) continue;
-            
-            int current_building_id = astronauts[i].current_building;
-            int best_pod = -1;
-            int best_distance_improvement = 0;
-            
-            // 현재 건물에 있는 모든 움직이는 포드 확인
-            for (int p = 0; p < pod_count; p++) {
-                if (!pods[p].is_moving) continue;
-                
-                // 포드가 현재 건물에서 출발하는지 확인
-                if (pods[p].path[pods[p].current_pos] == current_building_id) {
-                    int next_building_id = pods[p].path[pods[p].current_pos + 1];
-                    
-                    // 다음 건물이 목적지에 더 가깝게 하는지 확인
-                    int current_dist = calculate_distance_to_target(current_building_id, astronauts[i].type);
-                    int next_dist = calculate_distance_to_target(next_building_id, astronauts[i].type);
-                    
-                    if (next_dist != -1 && (current_dist == -1 || next_dist < current_dist)) {
-                        int improvement = current_dist - next_dist;
-                        if (improvement > best_distance_improvement) {
-                            best_distance_improvement = improvement;
-                            best_pod = p;
-                        }
-                    }
+        // 2단계: 작은 ID부터 튜브 용량 안에서 출발할 포드 결정
+        int touched[MAX_PODS];
+        int touched_count = 0;
+        for (int p = 0; p < pod_count; p++) {
+            const Pod* pod = &pods[p];
+            int position = sim_pod_position[p];
+            if (position >= pod->path_length - 1) {
+                // 처음과 끝이 같으면 순환, 아니면 마지막 정류장에 머묾
+                if (pod->path_length < 2 || pod->path[0] != pod->path[pod->path_length - 1]) {
+                    continue;
                 }
+                position = 0;
+                sim_pod_position[p] = 0;
+            }
+            int from = pod->path[position];
+            int to = pod->path[position + 1];
+            int route = (from >= 0 && to >= 0) ? route_between[from][to] : -1;
+            if (route == -1 || routes[route].capacity == 0) {
+                continue;
+            }
+            if (sim_tube_day[route] != day) {
+                sim_tube_day[route] = day;
+                sim_tube_usage[route] = 0;
             }
+            if (sim_tube_usage[route] >= routes[route].capacity) {
+                continue;
+            }
+            sim_tube_usage[route]++;
             
-            // 가장 좋은 포드에 우주비행사 할당
-            if (best_pod != -1) {
-                astronauts[i].pod_id = pods[best_pod].id;
-                fprintf(stderr, "Assigned astronaut %d to pod %d\n", i, pods[best_pod].id);
+            sim_pod_route[p] = route;
+            sim_pod_seats[p] = POD_CAPACITY;
+            sim_departure_next[p] = -1;
+            if (sim_departure_head[from] == -1) {
+                sim_departure_head[from] = p;
+                touched[touched_count++] = from;
+            } else {
+                sim_departure_next[sim_departure_tail[from]] = p;
             }
+            sim_departure_tail[from] = p;
         }
         
-        // 4단계: 포드 이동
-        for (int i = 0; i < pod_count; i++) {
-            if (pods[i].is_moving) {
-                int current_building = pods[i].path[pods[i].current_pos];
-                int next_building = pods[i].path[pods[i].current_pos + 1];
-                
-                // 모든 우주비행사 이동
-                for (int a = 0; a < astronaut_count; a++) {
-                    if (astronauts[a].pod_id == pods[i].id) {
-                        astronauts[a].current_building = next_building;
-                        astronauts[a].pod_id = -1;  // 포드에서 하차
-                        
-                        // 목적지 도착 확인
-                        int building_idx = find_building_index(next_building);
-                        if (building_idx != -1 && buildings[building_idx].type == astronauts[a].type) {
-                            astronauts[a].arrived = true;
-                            buildings_with_arrivals[building_idx]++;
-                            fprintf(stderr, "Astronaut %d arrived at destination!\n", a);
-                        }
-                    }
+        // 3단계: 우선순위 순으로 거리가 엄격히 줄어드는 포드 중 ID가 가장 작은 빈 포드에 탑승
+        for (int g = head; g != -1; g = sim_group_next[g]) {
+            int building = sim_group_building[g];
+            if (building < 0 || sim_group_moved_day[g] == day || sim_departure_head[building] == -1) {
+                continue;
+            }
+            int type = sim_group_type[g];
+            int current_distance = type_distance[building][type];
+            for (int p = sim_departure_head[building]; p != -1; p = sim_departure_next[p]) {
+                if (sim_pod_seats[p] == 0) {
+                    continue;
+                }
+                int to = pods[p].path[sim_pod_position[p] + 1];
+                if (type_distance[to][type] >= current_distance) {
+                    continue;
                 }
                 
-                // 포드 위치 업데이트
-                pods[i].current_pos++;
-                if (pods[i].current_pos >= pods[i].path_length - 1 && 
-                    pods[i].path[0] == pods[i].path[pods[i].path_length - 1]) {
-                    pods[i].current_pos = 0;  // 루프 시작으로 리셋
+                int boarding = g;
+                if (sim_group_size[g] > sim_pod_seats[p]) {
+                    // 빈 자리만큼 떼어 낸 무리를 바로 뒤에 삽입
+                    boarding = group_count++;
+                    sim_group_type[boarding] = (char)type;
+                    sim_group_size[boarding] = sim_pod_seats[p];
+                    sim_group_next[boarding] = sim_group_next[g];
+                    sim_group_next[g] = boarding;
+                    sim_group_size[g] -= sim_pod_seats[p];
                 }
+                sim_pod_seats[p] -= sim_group_size[boarding];
+                sim_pod_riders[p] += sim_group_size[boarding];
+                sim_route_riders[sim_pod_route[p]] += sim_group_size[boarding];
+                sim_group_building[boarding] = to;
+                sim_group_moved_day[boarding] = day;
+                if (buildings[to].type == type) {
+                    int points = sim_arrive(result, boarding, to, day + 1);
+                    PROFILE_POINTS(sim_pod_points, p, points);
+                    PROFILE_POINTS(sim_route_points, sim_pod_route[p], points);
+                }
+                if (boarding == g) {
+                    break;
+                }
+            }
+        }
+        
+        // 4단계: 출발한 포드를 다음 정류장으로
+        for (int i = 0; i < touched_count; i++) {
+            int building = touched[i];
+            for (int p = sim_departure_head[building]; p != -1; p = sim_departure_next[p]) {
+                sim_pod_position[p]++;
             }
+            sim_departure_head[building] = -1;
         }
     }
     
-    // 점수 계산
-    calculate_scores();
+    for (int g = head; g != -1; g = sim_group_next[g]) {
+        if (sim_group_building[g] >= 0) {
+            result->stranded += sim_group_size[g];
+        }
+    }
+    result->score = result->speed_score + result->balance_score;
+    PROFILE_END(PHASE_SIMULATION);
 }
 
-// 점수 계산 시스템
-void calculate_scores() {
-    int month_score = 0;
-    
-    for (int i = 0; i < astronaut_count; i++) {
-        if (astronauts[i].arrived) {
-            // 속도 점수: 50점에서 소요된 날짜 차감
-            int speed_score = 50 - (astronauts[i].arrival_day - astronauts[i].arrival_day);
-            if (speed_score < 0) speed_score = 0;
-            
-            // 인구 균형 점수: 50점에서 이미 도착한 우주비행사 수 차감
-            int building_idx = find_building_index(astronauts[i].current_building);
-            int balance_score = 50 - buildings_with_arrivals[building_idx] + 1;  // 자신은 제외
-            if (balance_score < 0) balance_score = 0;
-            
-            int total = speed_score + balance_score;
-            month_score += total;
-            
-            fprintf(stderr, "Astronaut %d scored %d points (speed: %d, balance: %d)\n",
-                    i, total, speed_score, balance_score);
-        }
+// ===== 월간 건설 계획 =====
+
+// 단조 시계 (ms)
+double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 마지막으로 추가한 경로 제거 (계획 되돌리기용, 거리 표는 호출한 쪽에서 복원)
+void remove_last_route() {
+    Route* route = &routes[--route_count];
+    int idx1 = route->index1;
+    int idx2 = route->index2;
+    route_between[idx1][idx2] = -1;
+    route_between[idx2][idx1] = -1;
+    if (route->capacity == 0) {
+        buildings[idx1].teleporter_exit = -1;
+        buildings[idx1].has_teleporter = false;
+        buildings[idx2].has_teleporter = false;
+    } else {
+        buildings[idx1].tube_count--;
+        buildings[idx2].tube_count--;
+        grid_remove_tube(route_count);
     }
-    
-    total_score += month_score;
-    fprintf(stderr, "Month %d score: %d, Total score: %d\n", month, month_score, total_score);
+    pending_route_count = 0;
+    adjacency_dirty = true;
 }
 
-// 매월 말 이자 계산
-void apply_interest(int* resources) {
-    int interest = (*resources) * 0.1;  // 10% 이자
-    *resources += interest;
-    fprintf(stderr, "Applied 10%% interest: +%d resources, new total: %d\n", interest, *resources);
+// 포드를 ID 순서를 유지하며 추가
+void insert_pod(const Pod* pod) {
+    int position = pod_count;
+    while (position > 0 && pods[position - 1].id > pod->id) {
+        pods[position] = pods[position - 1];
+        position--;
+    }
+    pods[position] = *pod;
+    pod_count++;
 }
 
-// 매월 초기화
-void initialize_monthly_data() {
-    // 착륙장에서 새로 도착한 우주비행사 설정
-    astronaut_count = 0;
-    
-    // 건물별 도착 우주비행사 수 초기화
-    for (int i = 0; i < building_count; i++) {
-        buildings_with_arrivals[i] = 0;
+// ID로 포드 제거 (없으면 false)
+bool remove_pod(int pod_id, Pod* removed) {
+    for (int p = 0; p < pod_count; p++) {
+        if (pods[p].id == pod_id) {
+            if (removed != NULL) {
+                *removed = pods[p];
+            }
+            memmove(&pods[p], &pods[p + 1], sizeof(Pod) * (pod_count - p - 1));
+            pod_count--;
+            return true;
+        }
     }
-    
-    // 이번 달에 이전 포드 위치 리셋
-    for (int i = 0; i < pod_count; i++) {
-        pods[i].current_pos = 0;
+    return false;
+}
+
+// 사용하지 않는 가장 작은 포드 ID (없으면 -1)
+int next_pod_id() {
+    int id = 1;
+    for (int p = 0; p < pod_count && pods[p].id <= id; p++) {
+        if (pods[p].id == id) {
+            id++;
+        }
     }
+    return id <= MAX_POD_ID ? id : -1;
 }
 
-// 게임 전략 실행 수정
-void execute_strategy(int resources) {
-    char actions[1024] = "";
-    int original_resources = resources; // 원래 자원 저장
-    
-    // 첫 번째 달: 착륙장과 해당하는 모듈 간에 튜브 연결
-    if (month == 0) {
-        // 착륙장 찾기
-        int landing_pads[MAX_BUILDINGS];
-        int landing_pad_count = 0;
-        
-        for (int i = 0; i < building_count; i++) {
-            if (buildings[i].type == LANDING_PAD) {
-                landing_pads[landing_pad_count++] = i;
+// 행동 적용 (규칙상 불가능하면 아무것도 바꾸지 않고 false), 비용은 action->cost에 기록
+bool apply_action(Action* action) {
+    int idx1 = action->building1;
+    int idx2 = action->building2;
+    switch (action->type) {
+        case ACTION_TUBE:
+            if (!can_build_tube(idx1, idx2)) {
+                return false;
             }
+            action->cost = calculate_tube_cost(buildings[idx1].id, buildings[idx2].id);
+            add_route(idx1, idx2, 1);
+            return true;
+        case ACTION_UPGRADE: {
+            int route = route_between[idx1][idx2];
+            if (route == -1 || routes[route].capacity == 0) {
+                return false;
+            }
+            action->cost = calculate_tube_cost(buildings[idx1].id, buildings[idx2].id) * (routes[route].capacity + 1);
+            routes[route].capacity++;
+            return true;
         }
-        
-        // 각 착륙장과 가까운 모듈 연결
-        for (int i = 0; i < landing_pad_count && resources > 0; i++) {
-            Building* landing = &buildings[landing_pads[i]];
-            
-            // 각 우주비행사 타입에 대해 가장 가까운 모듈 찾기
-            for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
-                if (landing->astronaut_count[type] > 0) {
-                    // 이 타입의 모든 모듈 찾기
-                    int closest_module = -1;
-                    double min_distance = 1e9;
-                    
-                    for (int j = 0; j < building_count; j++) {
-                        if (buildings[j].type == type) {
-                            double dist = calculate_distance(landing->x, landing->y, buildings[j].x, buildings[j].y);
-                            if (dist < min_distance) {
-                                min_distance = dist;
-                                closest_module = j;
-                            }
-                        }
-                    }
-                    
-                    // 가장 가까운 모듈에 연결
-                    if (closest_module != -1) {
-                        int landing_id = landing->id;
-                        int module_id = buildings[closest_module].id;
-                        
-                        if (can_build_tube(landing_id, module_id)) {
-                            int cost = calculate_tube_cost(landing_id, module_id);
-                            if (cost <= resources && cost > 0) {
-                                char tube_command[50];
-                                sprintf(tube_command, "%sTUBE %d %d;", actions[0] ? "" : "", landing_id, module_id);
-                                strcat(actions, tube_command);
-                                resources -= cost;
-                                
-                                // 로컬 데이터 업데이트
-                                Route* route = &routes[route_count++];
-                                route->building1 = landing_id;
-                                route->building2 = module_id;
-                                route->capacity = 1;
-                                route->length = min_distance;
-                                
-                                // 건물 인덱스 찾기
-                                int landing_idx = find_building_index(landing_id);
-                                int module_idx = find_building_index(module_id);
-                                
-                                if (landing_idx != -1 && module_idx != -1) {
-                                    buildings[landing_idx].connected_routes[buildings[landing_idx].route_count++] = route_count - 1;
-                                    buildings[module_idx].connected_routes[buildings[module_idx].route_count++] = route_count - 1;
-                                }
-                            }
-                        }
-                    }
+        case ACTION_TELEPORT:
+            // 경로 표는 건물 쌍마다 하나만 기록하므로 이미 튜브로 이어진 쌍에는 짓지 않음
+            if (idx1 == idx2 || route_between[idx1][idx2] != -1 ||
+                buildings[idx1].has_teleporter || buildings[idx2].has_teleporter) {
+                return false;
+            }
+            action->cost = TELEPORT_COST;
+            add_route(idx1, idx2, 0);
+            return true;
+        case ACTION_POD:
+            if (pod_count >= MAX_PODS || action->pod.id < 1) {
+                return false;
+            }
+            for (int i = 0; i + 1 < action->pod.path_length; i++) {
+                int route = route_between[action->pod.path[i]][action->pod.path[i + 1]];
+                if (route == -1 || routes[route].capacity == 0) {
+                    return false;
+                }
+            }
+            action->cost = POD_COST;
+            insert_pod(&action->pod);
+            return true;
+        case ACTION_DESTROY:
+            if (!remove_pod(action->pod.id, &action->pod)) {
+                return false;
+            }
+            action->cost = -POD_DESTROY_REFUND;
+            return true;
+    }
+    return false;
+}
+
+// apply_action의 반대 (적용한 역순으로 호출)
+void undo_action(const Action* action) {
+    switch (action->type) {
+        case ACTION_TUBE:
+        case ACTION_TELEPORT:
+            remove_last_route();
+            break;
+        case ACTION_UPGRADE:
+            routes[route_between[action->building1][action->building2]].capacity--;
+            break;
+        case ACTION_POD:
+            remove_pod(action->pod.id, NULL);
+            break;
+        case ACTION_DESTROY:
+            insert_pod(&action->pod);
+            break;
+    }
+}
+
+// 후보를 행동 목록으로 펼침 (노선은 없는 튜브 + 정류장을 왕복하는 순환 포드)
+int expand_candidate(const Candidate* candidate, Action* actions) {
+    int count = 0;
+    const int* stops = candidate->stops;
+    int stop_count = candidate->stop_count;
+    switch (candidate->type) {
+        case CANDIDATE_UPGRADE_SHUTTLE:
+            actions[count].type = ACTION_UPGRADE;
+            actions[count].building1 = stops[0];
+            actions[count].building2 = stops[1];
+            count++;
+            break;
+        case CANDIDATE_LINE:
+            for (int i = 0; i + 1 < stop_count; i++) {
+                if (route_between[stops[i]][stops[i + 1]] == -1) {
+                    actions[count].type = ACTION_TUBE;
+                    actions[count].building1 = stops[i];
+                    actions[count].building2 = stops[i + 1];
+                    count++;
                 }
             }
+            break;
+        case CANDIDATE_TELEPORT:
+            actions[count].type = ACTION_TELEPORT;
+            actions[count].building1 = stops[0];
+            actions[count].building2 = stops[1];
+            return count + 1;
+        case CANDIDATE_DESTROY:
+            actions[count].type = ACTION_DESTROY;
+            actions[count].pod.id = candidate->pod_id;
+            return count + 1;
+        case CANDIDATE_RELOCATE:
+            // 새 포드 ID는 철거 전에 정하므로 철거한 ID를 같은 턴에 다시 쓰지 않음
+            actions[count].type = ACTION_DESTROY;
+            actions[count].pod.id = candidate->pod_id;
+            count++;
+            break;
+        case CANDIDATE_SHUTTLE:
+            break;
+    }
+
+    // 정류장을 따라 갔다가 되돌아오는 순환 포드 (처음과 끝이 같음)
+    Action* pod = &actions[count++];
+    pod->type = ACTION_POD;
+    pod->pod.id = next_pod_id();
+    pod->pod.path_length = 0;
+    for (int i = 0; i < stop_count; i++) {
+        pod->pod.path[pod->pod.path_length++] = stops[i];
+    }
+    for (int i = stop_count - 2; i >= 0; i--) {
+        pod->pod.path[pod->pod.path_length++] = stops[i];
+    }
+    return count;
+}
+
+// 후보를 확정된 계획 위에 임시로 적용해 한 달 점수 계산 후 되돌림 (불가능하거나 예산 초과면 -1)
+int evaluate_candidate(const Candidate* candidate, int budget, int* cost) {
+    Action actions[MAX_LINE_STOPS + 1];
+    int count = expand_candidate(candidate, actions);
+    int applied = 0;
+    bool routes_added = false;
+    *cost = 0;
+    while (applied < count && apply_action(&actions[applied])) {
+        *cost += actions[applied].cost;
+        routes_added |= actions[applied].type == ACTION_TUBE || actions[applied].type == ACTION_TELEPORT;
+        applied++;
+    }
+
+    int score = -1;
+    if (applied == count && *cost <= budget) {
+        if (routes_added) {
+            update_distances();
         }
-        
-        // 초기 포드 생성 - 비용 확인
-        if (resources >= POD_COST) {
-            char pod_command[100];
-            
-            // 가장 첫 번째 착륙장에 포드 생성
-            if (landing_pad_count > 0 && buildings[landing_pads[0]].route_count > 0) {
-                int landing_id = buildings[landing_pads[0]].id;
-                int route_idx = buildings[landing_pads[0]].connected_routes[0];
-                int module_id = (routes[route_idx].building1 == landing_id) ? 
-                                routes[route_idx].building2 : routes[route_idx].building1;
-                
-                sprintf(pod_command, "%sPOD %d %d %d %d %d", actions[0] ? ";" : "", 1, landing_id, module_id, landing_id, module_id);
-                strcat(actions, pod_command);
-                resources -= POD_COST;
+        MonthResult result;
+        simulate_month(&result);
+        score = result.score;
+    }
+
+    while (applied > 0) {
+        undo_action(&actions[--applied]);
+    }
+    if (routes_added) {
+        memcpy(type_distance, committed_distance, sizeof(type_distance[0]) * building_count);
+    }
+    return score;
+}
+
+Candidate* add_candidate(CandidateType type, const int* stops, int stop_count, double ratio) {
+    if (candidate_count >= MAX_CANDIDATES) {
+        return NULL;
+    }
+    Candidate* candidate = &candidates[candidate_count++];
+    candidate->type = type;
+    if (stop_count > 0) {
+        memcpy(candidate->stops, stops, sizeof(int) * stop_count);
+    }
+    candidate->stop_count = stop_count;
+    candidate->pod_id = -1;
+    candidate->ratio = ratio;
+    return candidate;
+}
+
+// 노선 끝에서 아직 못 태운 인원이 가장 많은 튜브를 따라 정류장을 이어 붙임
+int extend_loop(int* stops, int stop_count, const double* unmet, bool* visited) {
+    while (stop_count < MAX_LINE_STOPS) {
+        int tail = stops[stop_count - 1];
+        int next = -1;
+        for (int e = adjacency_start[tail]; e < adjacency_start[tail + 1]; e++) {
+            int neighbor = adjacency_source[e];
+            if (adjacency_weight[e] == 1 && !visited[neighbor] && unmet[route_between[tail][neighbor]] > 0 &&
+                (next == -1 || unmet[route_between[tail][neighbor]] > unmet[route_between[tail][next]])) {
+                next = neighbor;
             }
         }
-    } else {
-        // 이후 달: 네트워크 확장 및 업그레이드
+        if (next == -1) {
+            break;
+        }
+        visited[next] = true;
+        stops[stop_count++] = next;
+    }
+    return stop_count;
+}
+
+// 착륙장 입구와 모든 출구 쌍의 텔레포터를 줄어드는 우주비행사·일 수로 순위를 매겨 상위만 후보로 추가
+// (중간 건물 입구는 그 달 점수는 올려도 이후 달에 손해인 경우가 많아 제외)
+// 입구를 거쳐 가는 타입별 인원 x (입구 거리 - 출구 거리), 지금 도달할 수 없는 인원은 한 달 전체를 줄인다고 봄
+// (입구로 새로 모여드는 인원은 세지 않으므로 근사치, 최종 판단은 시뮬레이션)
+void add_teleport_candidates() {
+    int best_pairs[TELEPORT_CANDIDATES][2];
+    double best_saved[TELEPORT_CANDIDATES];
+    int best_count = 0;
+    
+    for (int entrance = 0; entrance < building_count; entrance++) {
+        if (buildings[entrance].has_teleporter || buildings[entrance].type != LANDING_PAD) {
+            continue;
+        }
+        // 입구를 거쳐 가는 인원이 있는 타입만 모아 두고 모든 출구에 재사용
+        int types[MODULE_TYPE_COUNT];
+        int type_count = 0;
+        for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
+            if (node_type_flow[entrance][type] > 0 && buildings[entrance].type != type) {
+                types[type_count++] = type;
+            }
+        }
+        if (type_count == 0) {
+            continue;
+        }
         
-        // 새 건물들을 기존 네트워크에 연결 - 비용 확인 후 연결
-        for (int i = 0; i < building_count && resources > 0; i++) {
-            if (buildings[i].route_count == 0) {
-                // 가장 가까운 건물 찾기
-                int closest_building = -1;
-                double min_distance = 1e9;
-                
-                for (int j = 0; j < building_count; j++) {
-                    if (i != j && buildings[j].route_count > 0) {
-                        double dist = calculate_distance(buildings[i].x, buildings[i].y, buildings[j].x, buildings[j].y);
-                        if (dist < min_distance) {
-                            min_distance = dist;
-                            closest_building = j;
-                        }
-                    }
-                }
-                
-                // 연결 시도 전 비용 확인
-                if (closest_building != -1) {
-                    int id1 = buildings[i].id;
-                    int id2 = buildings[closest_building].id;
-                    
-                    if (can_build_tube(id1, id2)) {
-                        int cost = calculate_tube_cost(id1, id2);
-                        if (cost <= resources && cost > 0) {
-                            char command[50];
-                            sprintf(command, "%sTUBE %d %d", actions[0] ? ";" : "", id1, id2);
-                            strcat(actions, command);
-                            resources -= cost;
-                        }
-                    }
+        for (int exit = 0; exit < building_count; exit++) {
+            if (exit == entrance || buildings[exit].has_teleporter || route_between[entrance][exit] != -1) {
+                continue;
+            }
+            double saved = 0;
+            for (int i = 0; i < type_count; i++) {
+                int type = types[i];
+                int before = type_distance[entrance][type];
+                int after = type_distance[exit][type];
+                if (after < before) {
+                    int days = before - after < MONTH_DAYS ? before - after : MONTH_DAYS;
+                    saved += node_type_flow[entrance][type] * days;
                 }
             }
+            if (saved <= 0 || (best_count == TELEPORT_CANDIDATES && saved <= best_saved[best_count - 1])) {
+                continue;
+            }
+            int k = best_count < TELEPORT_CANDIDATES ? best_count++ : best_count - 1;
+            while (k > 0 && best_saved[k - 1] < saved) {
+                best_saved[k] = best_saved[k - 1];
+                best_pairs[k][0] = best_pairs[k - 1][0];
+                best_pairs[k][1] = best_pairs[k - 1][1];
+                k--;
+            }
+            best_saved[k] = saved;
+            best_pairs[k][0] = entrance;
+            best_pairs[k][1] = exit;
+        }
+    }
+    
+    for (int i = 0; i < best_count; i++) {
+        add_candidate(CANDIDATE_TELEPORT, best_pairs[i], 2, UNEVALUATED);
+    }
+}
+
+// 혼잡한 튜브들을 잇는 기존 튜브 위 순환 포드 노선과, 한가한 포드를 그 노선으로 옮기는 후보
+// 못 태운 인원은 수요 흐름의 통과 인원에서 확정된 계획의 한 달 시뮬레이션으로 실제 태운 인원을 뺀 값
+void add_loop_candidates() {
+    // 마지막 시뮬레이션은 되돌린 후보의 것일 수 있으므로 확정된 계획으로 다시 시뮬레이션
+    MonthResult committed;
+    simulate_month(&committed);
+    
+    double unmet[MAX_TUBES];
+    for (int r = 0; r < route_count; r++) {
+        unmet[r] = routes[r].capacity > 0 ? route_load[r] - sim_route_riders[r] : 0;
+    }
+    
+    // 포드마다 태운 인원이 적은 순으로 RELOCATE_PODS개 (한 번 가득 채운 적도 없는 포드만)
+    int idle[RELOCATE_PODS];
+    int idle_count = 0;
+    for (int p = 0; p < pod_count; p++) {
+        if (sim_pod_riders[p] >= POD_CAPACITY) {
+            continue;
+        }
+        if (idle_count == RELOCATE_PODS && sim_pod_riders[idle[idle_count - 1]] <= sim_pod_riders[p]) {
+            continue;
+        }
+        int k = idle_count < RELOCATE_PODS ? idle_count++ : idle_count - 1;
+        while (k > 0 && sim_pod_riders[idle[k - 1]] > sim_pod_riders[p]) {
+            idle[k] = idle[k - 1];
+            k--;
+        }
+        idle[k] = p;
+    }
+    
+    bool seeded[MAX_TUBES] = {false};
+    for (int seed = 0; seed < LOOP_SEEDS; seed++) {
+        int best = -1;
+        for (int r = 0; r < route_count; r++) {
+            if (!seeded[r] && unmet[r] > 0 && (best == -1 || unmet[r] > unmet[best])) {
+                best = r;
+            }
         }
+        if (best == -1) {
+            break;
+        }
+        seeded[best] = true;
         
-        // 혼잡한 튜브 업그레이드 - 비용 계산 확인 후 업그레이드
-        int upgrades_done = 0; // 각 턴에 업그레이드 수 제한
+        // 씨앗 튜브에서 양쪽으로 늘림 (뒤쪽은 뒤집어서 늘린 뒤 다시 뒤집음)
+        bool visited[MAX_BUILDINGS] = {false};
+        int stops[MAX_LINE_STOPS];
+        stops[0] = routes[best].index1;
+        stops[1] = routes[best].index2;
+        visited[stops[0]] = visited[stops[1]] = true;
+        int stop_count = extend_loop(stops, 2, unmet, visited);
+        for (int i = 0; i < stop_count / 2; i++) {
+            int swap = stops[i];
+            stops[i] = stops[stop_count - 1 - i];
+            stops[stop_count - 1 - i] = swap;
+        }
+        stop_count = extend_loop(stops, stop_count, unmet, visited);
         
-        for (int i = 0; i < route_count && resources > 0 && upgrades_done < 2; i++) {
-            if (routes[i].capacity > 0 && routes[i].capacity < 3) {  // 용량이 3 미만인 튜브만 업그레이드
-                int base_cost = calculate_tube_cost(routes[i].building1, routes[i].building2);
-                int upgrade_cost = base_cost * (routes[i].capacity + 1);
-                
-                // 충분한 자원이 있는 경우에만 업그레이드
-                if (upgrade_cost <= resources && upgrade_cost > 0) {
-                    char command[50];
-                    sprintf(command, "%sUPGRADE %d %d", actions[0] ? ";" : "", routes[i].building1, routes[i].building2);
-                    strcat(actions, command);
-                    resources -= upgrade_cost;
-                    upgrades_done++;
-                }
+        if (stop_count > 2) {
+            add_candidate(CANDIDATE_LINE, stops, stop_count, UNEVALUATED);
+        }
+        for (int i = 0; i < idle_count; i++) {
+            Candidate* candidate = add_candidate(CANDIDATE_RELOCATE, stops, stop_count, UNEVALUATED);
+            if (candidate != NULL) {
+                candidate->pod_id = pods[idle[i]].id;
             }
         }
-        
-        // 중요 경로에 텔레포터 설치 - 충분한 자원 확인
-        if (resources >= TELEPORT_COST && month >= 5) {
-            // 가장 멀리 떨어진 착륙장-모듈 쌍 찾기
-            int landing_pad_id = -1;
-            int module_id = -1;
-            double max_distance = 0;
-            
-            for (int i = 0; i < building_count; i++) {
-                if (buildings[i].type == LANDING_PAD && !buildings[i].has_teleporter) {
-                    for (int j = 0; j < building_count; j++) {
-                        if (buildings[j].type > 0 && !buildings[j].has_teleporter) {  // 모듈
-                            double dist = calculate_distance(buildings[i].x, buildings[i].y, buildings[j].x, buildings[j].y);
-                            if (dist > max_distance) {
-                                max_distance = dist;
-                                landing_pad_id = buildings[i].id;
-                                module_id = buildings[j].id;
-                            }
-                        }
-                    }
-                }
+    }
+}
+
+// 건물마다 지금 튜브를 지을 수 있는 가장 가까운 건물 TUBE_NEIGHBORS개
+void collect_tube_neighbors() {
+    for (int i = 0; i < building_count; i++) {
+        int count = 0;
+        double neighbor_distance[TUBE_NEIGHBORS];
+        for (int j = 0; j < building_count; j++) {
+            if (i == j || route_between[i][j] != -1) {
+                continue;
             }
-            
-            // 텔레포터 설치
-            if (landing_pad_id != -1 && module_id != -1) {
-                char command[50];
-                sprintf(command, "%sTELEPORT %d %d", actions[0] ? ";" : "", landing_pad_id, module_id);
-                strcat(actions, command);
-                resources -= TELEPORT_COST;
-                
-                // 데이터 업데이트
-                for (int i = 0; i < building_count; i++) {
-                    if (buildings[i].id == landing_pad_id || buildings[i].id == module_id) {
-                        buildings[i].has_teleporter = true;
-                    }
-                }
+            double distance = calculate_distance(buildings[i].x, buildings[i].y, buildings[j].x, buildings[j].y);
+            if (count == TUBE_NEIGHBORS && distance >= neighbor_distance[count - 1]) {
+                continue;
+            }
+            if (!can_build_tube(i, j)) {
+                continue;
             }
+            int k = count < TUBE_NEIGHBORS ? count++ : count - 1;
+            while (k > 0 && neighbor_distance[k - 1] > distance) {
+                neighbor_distance[k] = neighbor_distance[k - 1];
+                tube_neighbors[i][k] = tube_neighbors[i][k - 1];
+                k--;
+            }
+            neighbor_distance[k] = distance;
+            tube_neighbors[i][k] = j;
         }
-        
-        // 추가 포드 생성 - 각 턴에 생성할 포드 수 제한
-        int pods_created = 0;
-        while (pods_created < 2 && resources >= POD_COST) {
-            // 가장 활용도가 높은 튜브 찾기
-            if (route_count > 0) {
-                int route_idx = pod_count % route_count;  // 단순히 고르게 분배
-                int b1_id = routes[route_idx].building1;
-                int b2_id = routes[route_idx].building2;
-                
-                // 건물 ID가 실제 존재하는지 확인
-                int b1_idx = find_building_index(b1_id);
-                int b2_idx = find_building_index(b2_id);
-                
-                if (b1_idx != -1 && b2_idx != -1) {
-                    char command[100];
-                    sprintf(command, "%sPOD %d %d %d %d %d", 
-                           actions[0] ? ";" : "", pod_count + 1, b1_id, b2_id, b1_id, b2_id);
-                    strcat(actions, command);
-                    resources -= POD_COST;
-                    pod_count++;
-                    pods_created++;
-                }
-            } else {
+        tube_neighbor_count[i] = count;
+    }
+}
+
+// 착륙장에서 도착 타입별로 가장 싼 노선 후보 (기존 튜브 + 지을 수 있는 가까운 튜브 위 다익스트라)
+void add_line_candidates(int pad) {
+    int cost[MAX_BUILDINGS];
+    int previous[MAX_BUILDINGS];
+    bool done[MAX_BUILDINGS];
+    for (int i = 0; i < building_count; i++) {
+        cost[i] = INT_MAX_COST;
+        previous[i] = -1;
+        done[i] = false;
+    }
+    cost[pad] = 0;
+
+    for (int step = 0; step < building_count; step++) {
+        int u = -1;
+        for (int i = 0; i < building_count; i++) {
+            if (!done[i] && cost[i] < INT_MAX_COST && (u == -1 || cost[i] < cost[u])) {
+                u = i;
+            }
+        }
+        if (u == -1) {
+            break;
+        }
+        done[u] = true;
+
+        // 기존 튜브는 정류장 비용만, 새 튜브는 건설비 추가
+        for (int v = 0; v < building_count; v++) {
+            int route = route_between[u][v];
+            if (route != -1 && routes[route].capacity > 0 && cost[u] + LINE_HOP_COST < cost[v]) {
+                cost[v] = cost[u] + LINE_HOP_COST;
+                previous[v] = u;
+            }
+        }
+        for (int k = 0; k < tube_neighbor_count[u]; k++) {
+            int v = tube_neighbors[u][k];
+            int candidate_cost = cost[u] + LINE_HOP_COST + calculate_tube_cost(buildings[u].id, buildings[v].id);
+            if (candidate_cost < cost[v]) {
+                cost[v] = candidate_cost;
+                previous[v] = u;
+            }
+        }
+    }
+
+    for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
+        if (buildings[pad].astronaut_count[type] == 0) {
+            continue;
+        }
+        int target = -1;
+        for (int i = 0; i < building_count; i++) {
+            if (buildings[i].type == type && cost[i] < INT_MAX_COST && (target == -1 || cost[i] < cost[target])) {
+                target = i;
+            }
+        }
+        if (target == -1) {
+            continue;
+        }
+
+        int stops[MAX_BUILDINGS];
+        int stop_count = 0;
+        for (int v = target; v != -1; v = previous[v]) {
+            stops[stop_count++] = v;
+        }
+        if (stop_count < 2 || stop_count > MAX_LINE_STOPS) {
+            continue;
+        }
+        // 착륙장에서 출발하도록 뒤집음
+        for (int i = 0; i < stop_count / 2; i++) {
+            int swap = stops[i];
+            stops[i] = stops[stop_count - 1 - i];
+            stops[stop_count - 1 - i] = swap;
+        }
+        add_candidate(CANDIDATE_LINE, stops, stop_count, UNEVALUATED);
+    }
+}
+
+// 현재 네트워크 기준 후보 목록 생성
+void generate_candidates(int budget) {
+    // 되돌린 후보의 튜브가 인접 리스트에 남아 있을 수 있음 (remove_last_route는 표시만 함)
+    if (adjacency_dirty) {
+        rebuild_adjacency();
+    }
+    candidate_count = 0;
+    collect_tube_neighbors();
+    route_demand_flows();
+    count_pod_seats();
+
+    // 기존 튜브: 좌석이 모자란 튜브에만 왕복 포드 추가, 포드가 용량만큼 있으면 업그레이드 후 추가
+    // 첫 평가 순서는 지나는 인원이 모두 만점으로 도착한다고 본 자원당 점수 (지연 탐욕의 상한 역할)
+    for (int r = 0; r < route_count; r++) {
+        if (routes[r].capacity == 0 || route_load[r] <= route_seats[r]) {
+            continue;
+        }
+        int stops[2] = {routes[r].index1, routes[r].index2};
+        double best_gain = route_load[r] * (SPEED_POINTS + BALANCE_POINTS);
+        if (route_pods[r] < routes[r].capacity) {
+            add_candidate(CANDIDATE_SHUTTLE, stops, 2, best_gain / POD_COST);
+        } else {
+            int upgrade_cost = calculate_tube_cost(buildings[stops[0]].id, buildings[stops[1]].id) * (routes[r].capacity + 1);
+            add_candidate(CANDIDATE_UPGRADE_SHUTTLE, stops, 2, best_gain / (POD_COST + upgrade_cost));
+        }
+    }
+
+    // 새 튜브 하나 + 왕복 포드 (양쪽 목록에 모두 있으면 한 번만)
+    for (int i = 0; i < building_count; i++) {
+        for (int k = 0; k < tube_neighbor_count[i]; k++) {
+            int j = tube_neighbors[i][k];
+            bool listed_by_j = false;
+            for (int q = 0; q < tube_neighbor_count[j]; q++) {
+                listed_by_j |= tube_neighbors[j][q] == i;
+            }
+            if (!listed_by_j || i < j) {
+                int stops[2] = {i, j};
+                add_candidate(CANDIDATE_LINE, stops, 2, UNEVALUATED);
+            }
+        }
+    }
+
+    // 착륙장에서 필요한 모듈까지의 노선
+    for (int pad = 0; pad < building_count; pad++) {
+        if (buildings[pad].type != LANDING_PAD) {
+            continue;
+        }
+        add_line_candidates(pad);
+    }
+    if (budget >= TELEPORT_COST) {
+        add_teleport_candidates();
+    }
+
+    // 혼잡한 튜브를 잇는 순환 포드, 한가한 포드 옮기기
+    add_loop_candidates();
+
+    // 포드 철거 (점수가 줄지 않으면 환급만큼 이득)
+    for (int p = 0; p < pod_count; p++) {
+        Candidate* candidate = add_candidate(CANDIDATE_DESTROY, NULL, 0, UNEVALUATED);
+        if (candidate != NULL) {
+            candidate->pod_id = pods[p].id;
+        }
+    }
+}
+
+int compare_candidates(const void* a, const void* b) {
+    double ratio_a = ((const Candidate*)a)->ratio;
+    double ratio_b = ((const Candidate*)b)->ratio;
+    return (ratio_a < ratio_b) - (ratio_a > ratio_b);
+}
+
+// 행동 하나를 명령으로 출력 (건물은 ID로)
+void write_action(const Action* action) {
+    switch (action->type) {
+        case ACTION_TUBE:
+            write_string("TUBE ");
+            break;
+        case ACTION_UPGRADE:
+            write_string("UPGRADE ");
+            break;
+        case ACTION_TELEPORT:
+            write_string("TELEPORT ");
+            break;
+        case ACTION_POD:
+            write_string("POD ");
+            write_int(action->pod.id);
+            for (int i = 0; i < action->pod.path_length; i++) {
+                write_char(' ');
+                write_int(buildings[action->pod.path[i]].id);
+            }
+            return;
+        case ACTION_DESTROY:
+            write_string("DESTROY ");
+            write_int(action->pod.id);
+            return;
+    }
+    write_int(buildings[action->building1].id);
+    write_char(' ');
+    write_int(buildings[action->building2].id);
+}
+
+// 후보를 한 달 시뮬레이션으로 평가해 자원당 점수 증가가 가장 큰 후보를 하나씩 확정 (지연 탐욕)
+// 지난 평가의 자원당 증가를 상한으로 보고, 확정 후에는 그 상한이 현재 최고보다 큰 후보만 다시 평가
+// 확정한 후보는 계획 단계로 기록하고 확정한 단계 수를 돌려줌
+int plan_greedy(int* budget, int* base_score, double deadline_ms, int* evaluations) {
+    int committed = 0;
+    generate_candidates(*budget);
+
+    while (now_ms() < deadline_ms) {
+        qsort(candidates, candidate_count, sizeof(Candidate), compare_candidates);
+        int best = -1;
+        double best_ratio = 0;
+        int best_cost = 0;
+        int best_gain = 0;
+        for (int c = 0; c < candidate_count; c++) {
+            if (candidates[c].ratio < 0 || (best != -1 && candidates[c].ratio <= best_ratio)) {
+                break;
+            }
+            if (now_ms() >= deadline_ms) {
                 break;
             }
+            int cost;
+            int score = evaluate_candidate(&candidates[c], *budget, &cost);
+            (*evaluations)++;
+            int gain = score - *base_score;
+            if (score < 0) {
+                candidates[c].ratio = -1;
+            } else if (cost <= 0) {
+                // 철거: 점수가 줄지 않으면 무조건 이득
+                candidates[c].ratio = gain >= 0 ? UNEVALUATED / 2 : -1;
+            } else {
+                candidates[c].ratio = (double)gain / cost;
+            }
+            if (candidates[c].ratio > best_ratio && (gain > 0 || cost <= 0)) {
+                best = c;
+                best_ratio = candidates[c].ratio;
+                best_cost = cost;
+                best_gain = gain;
+            }
+        }
+        if (best == -1 || plan_action_count + MAX_LINE_STOPS + 1 > MAX_PLAN_ACTIONS) {
+            break;
+        }
+
+        // 최고 후보 확정
+        Action actions[MAX_LINE_STOPS + 1];
+        int count = expand_candidate(&candidates[best], actions);
+        bool routes_added = false;
+        for (int i = 0; i < count; i++) {
+            apply_action(&actions[i]);
+            routes_added |= actions[i].type == ACTION_TUBE || actions[i].type == ACTION_TELEPORT;
+            plan_actions[plan_action_count++] = actions[i];
+        }
+        step_cost[step_count] = best_cost;
+        step_gain[step_count] = best_gain;
+        step_action_end[step_count] = plan_action_count;
+        step_count++;
+        committed++;
+        *budget -= best_cost;
+        if (routes_added) {
+            update_distances();
+            memcpy(committed_distance, type_distance, sizeof(type_distance[0]) * building_count);
+        }
+        MonthResult result;
+        simulate_month(&result);
+        *base_score = result.score;
+        if (routes_added) {
+            // 새 튜브로 생긴 왕복·노선 후보를 다시 만듦 (기존 평가는 상한으로 유지할 수 없으니 모두 재평가)
+            generate_candidates(*budget);
         }
     }
-    
-    // 디버깅용 - 자원 사용량 확인
-    fprintf(stderr, "Month %d: Resources before=%d, after=%d, used=%d\n", 
-            month, original_resources, resources, original_resources - resources);
-    
-    // 명령 실행 (또는 WAIT)
-    if (actions[0]) {
-        printf("%s\n", actions);
-    } else {
-        printf("WAIT\n");
+    return committed;
+}
+
+// 지금 앞의 prefix 단계만 사고, 다음 달부터는 이자와 예상 수입으로 남은 단계를 순서대로 살 수 있을 때 산다고 할 때
+// 남은 달 전체에서 얻는 점수 증가의 합 (내다본 단계를 다 사면 그 뒤로는 그대로)
+double schedule_value(int prefix, int resources, int months_left) {
+    double money = resources;
+    double gain = 0;
+    for (int i = 0; i < prefix; i++) {
+        money -= step_cost[i];
+        gain += step_gain[i];
     }
-    
+    double total = gain;
+    int bought = prefix;
+    for (int k = 1; k < months_left; k++) {
+        money = floor(money * (100 + INTEREST_PERCENT) / 100) + expected_income;
+        while (bought < step_count && step_cost[bought] <= money) {
+            money -= step_cost[bought];
+            gain += step_gain[bought];
+            bought++;
+        }
+        total += gain;
+    }
+    return total;
+}
+
+// 월간 계획: 이번 달 예산으로 탐욕 계획을 세운 뒤 몇 달 치 예상 자원으로 계획을 이어 가고,
+// 이번 달에 살 단계 수는 지금 사는 것과 아껴서 이자를 받고 나중에 사는 것을 남은 달 전체 점수로 비교해 정함
+void execute_strategy(int resources, double deadline_ms) {
+    PROFILE_BEGIN(PHASE_PLAN);
+    int budget = resources;
+    memcpy(month_distance, type_distance, sizeof(type_distance[0]) * building_count);
+    memcpy(committed_distance, type_distance, sizeof(type_distance[0]) * building_count);
+    plan_action_count = 0;
+    step_count = 0;
+
+    // 수입 모델 갱신 (입력 자원에는 지난달 남긴 자원의 이자가 이미 포함됨)
+    if (resources_left >= 0) {
+        int income = resources - (resources_left + resources_left * INTEREST_PERCENT / 100);
+        expected_income = (expected_income * income_samples + income) / (income_samples + 1);
+        income_samples++;
+    }
+
+    MonthResult base;
+    simulate_month(&base);
+    PROFILE_ATTRIBUTE();
+    int base_score = base.score;
+    int evaluations = 0;
+    int affordable = plan_greedy(&budget, &base_score, deadline_ms, &evaluations);
+    int month_score = base_score;
+
+    // 다음 몇 달 동안 모일 자원만큼 계획을 이어 감 (실제로 사는 것은 이번 달 예산 안의 단계뿐)
+    int months_left = MONTH_COUNT - month;
+    int horizon = months_left - 1 < LOOKAHEAD_MONTHS ? months_left - 1 : LOOKAHEAD_MONTHS;
+    double future = 0;
+    for (int k = 0; k < horizon; k++) {
+        future = future * (100 + INTEREST_PERCENT) / 100 + expected_income;
+    }
+    if (horizon > 0) {
+        int lookahead_budget = budget + (int)(budget * (pow(1.0 + INTEREST_PERCENT / 100.0, horizon) - 1) + future);
+        plan_greedy(&lookahead_budget, &base_score, deadline_ms, &evaluations);
+    }
+
+    int chosen = affordable;
+    double chosen_value = schedule_value(affordable, resources, months_left);
+    for (int prefix = affordable - 1; prefix >= 0; prefix--) {
+        double value = schedule_value(prefix, resources, months_left);
+        if (value > chosen_value) {
+            chosen = prefix;
+            chosen_value = value;
+        }
+    }
+    int spent = 0;
+    for (int i = 0; i < chosen; i++) {
+        spent += step_cost[i];
+    }
+    int output_count = chosen > 0 ? step_action_end[chosen - 1] : 0;
+    resources_left = resources - spent;
+
+    // 월간 요약 한 줄 (프로파일 빌드에서는 단계별 시간과 점수 기여를 덧붙임)
+    PROFILE_END(PHASE_PLAN);
+    fprintf(stderr, "Month %d: %d points (%d arrived, %d stranded), plan %d of %d steps (%d affordable) -> %d points, "
+            "spent %d of %d, income %.0f, %d evaluations",
+            month, base.score, base.arrived, base.stranded, chosen, step_count, affordable, month_score,
+            spent, resources, expected_income, evaluations);
+    PROFILE_REPORT();
+    fputc('\n', stderr);
+
+    // 명령 출력 (없으면 WAIT)
+    for (int i = 0; i < output_count; i++) {
+        if (i > 0) {
+            write_char(';');
+        }
+        write_action(&plan_actions[i]);
+    }
+    if (output_count == 0) {
+        write_string("WAIT");
+    }
+    write_char('\n');
+    flush_output();
+
+    // 다음 달 입력이 실제 결과이므로 계획은 모두 되돌림
+    for (int i = plan_action_count - 1; i >= 0; i--) {
+        undo_action(&plan_actions[i]);
+    }
+    memcpy(type_distance, month_distance, sizeof(type_distance[0]) * building_count);
+
     month++;
 }
 
+#ifdef SELENIA_PROFILE
+// 현재 네트워크를 시뮬레이션한 직후 호출: 종류별 기여 합과 가장 많이 기여한 튜브, 포드 기록
+void profile_attribute() {
+    attributed_tube_points = attributed_pod_points = attributed_teleport_points = 0;
+    top_route = top_pod = -1;
+    top_route_points = top_pod_points = 0;
+    for (int r = 0; r < route_count; r++) {
+        attributed_tube_points += sim_route_points[r];
+        if (sim_route_points[r] > top_route_points) {
+            top_route = r;
+            top_route_points = sim_route_points[r];
+        }
+    }
+    for (int p = 0; p < pod_count; p++) {
+        attributed_pod_points += sim_pod_points[p];
+        if (sim_pod_points[p] > top_pod_points) {
+            top_pod = p;
+            top_pod_points = sim_pod_points[p];
+        }
+    }
+    for (int b = 0; b < building_count; b++) {
+        attributed_teleport_points += sim_teleport_points[b];
+    }
+}
+
+// 요약 줄 뒤에 단계별 누적 시간과 점수 기여를 덧붙이고 누적값 초기화
+void profile_report() {
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        fprintf(stderr, " | %s %.1f ms x%d", profile_phase_names[phase], profile_ms[phase], profile_calls[phase]);
+        profile_ms[phase] = 0;
+        profile_calls[phase] = 0;
+    }
+    fprintf(stderr, " | points: tubes %d, teleporters %d", attributed_tube_points, attributed_teleport_points);
+    if (top_route != -1) {
+        fprintf(stderr, ", top tube %d-%d %d", routes[top_route].building1, routes[top_route].building2, top_route_points);
+    }
+    if (top_pod != -1) {
+        fprintf(stderr, ", top pod %d %d of %d", pods[top_pod].id, top_pod_points, attributed_pod_points);
+    }
+}
+#endif
+
 int main()
 {
     // 전역 변수 초기화
     building_count = 0;
     route_count = 0;
     pod_count = 0;
-    astronaut_count = 0;
+    astronaut_type_total = 0;
     month = 0;
-    total_score = 0;
-    
-    for (int i = 0; i < MAX_BUILDINGS; i++) {
-        buildings_with_arrivals[i] = 0;
-    }
     
     // 게임 루프
     while (1) {
         int resources;
-        scanf("%d", &resources);
-        
-        // 디버깅용 - 각 턴마다 자원 확인
-        fprintf(stderr, "Starting month %d with %d resources\n", month, resources);
-        
-        // 이전 달이 끝났으면 이자 적용 (첫 달 제외)
-        if (month > 0) {
-            apply_interest(&resources);
+        if (!read_int(&resources)) {
+            break;
         }
-        
-        // 매월 데이터 초기화
-        initialize_monthly_data();
+        double turn_start_ms = now_ms();
+        PROFILE_BEGIN(PHASE_PARSE);
         
         int num_travel_routes;
-        scanf("%d", &num_travel_routes);
-        
-        // 각 건물의 route_count 초기화
-        for (int i = 0; i < building_count; i++) {
-            buildings[i].route_count = 0;
-        }
-        
-        route_count = 0;
+        read_int(&num_travel_routes);
         
+        // 경로는 영구적이므로 처음 보는 경로만 추가하고 기존 경로는 용량만 갱신
         for (int i = 0; i < num_travel_routes; i++) {
             int building_id_1;
             int building_id_2;
             int capacity;
-            scanf("%d%d%d", &building_id_1, &building_id_2, &capacity);
-            
-            // 경로 정보 저장
-            routes[route_count].building1 = building_id_1;
-            routes[route_count].building2 = building_id_2;
-            routes[route_count].capacity = capacity;
+            read_int(&building_id_1);
+            read_int(&building_id_2);
+            read_int(&capacity);
             
-            // 길이 계산
             int b1_idx = find_building_index(building_id_1);
             int b2_idx = find_building_index(building_id_2);
+            if (b1_idx == -1 || b2_idx == -1) {
+                continue;
+            }
             
-            if (b1_idx != -1 && b2_idx != -1) {
-                routes[route_count].length = calculate_distance(
-                    buildings[b1_idx].x, buildings[b1_idx].y,
-                    buildings[b2_idx].x, buildings[b2_idx].y
-                );
-                
-                // 건물의 연결 정보 업데이트
-                if (buildings[b1_idx].route_count < 5) {
-                    buildings[b1_idx].connected_routes[buildings[b1_idx].route_count++] = route_count;
-                }
-                if (buildings[b2_idx].route_count < 5) {
-                    buildings[b2_idx].connected_routes[buildings[b2_idx].route_count++] = route_count;
-                }
+            int route_idx = route_between[b1_idx][b2_idx];
+            if (route_idx == -1) {
+                add_route(b1_idx, b2_idx, capacity);
             } else {
-                // 건물을 찾지 못한 경우 길이 0으로 설정
-                routes[route_count].length = 0;
+                routes[route_idx].capacity = capacity;
             }
-            
-            route_count++;
         }
         
         int num_pods;
-        scanf("%d", &num_pods); fgetc(stdin);
+        read_int(&num_pods);
         pod_count = 0;
         
         for (int i = 0; i < num_pods; i++) {
-            char pod_properties[201];
-            scanf("%[^\n]", pod_properties); fgetc(stdin);
-            parse_pod_properties(pod_properties);
+            parse_pod_properties();
         }
+        sort_pods();
         
         int num_new_buildings;
-        scanf("%d", &num_new_buildings); fgetc(stdin);
+        read_int(&num_new_buildings);
         
         for (int i = 0; i < num_new_buildings; i++) {
-            char building_properties[501];
-            scanf("%[^\n]", building_properties); fgetc(stdin);
-            parse_building_properties(building_properties);
+            parse_building_properties();
         }
         
-        // 새 우주비행사 데이터 구성 (착륙장 파싱 시)
-        for (int i = 0; i < building_count; i++) {
-            if (buildings[i].type == LANDING_PAD) {
-                for (int type = 1; type <= MODULE_TYPE_COUNT; type++) {
-                    for (int j = 0; j < buildings[i].astronaut_count[type]; j++) {
-                        astronauts[astronaut_count].id = astronaut_count;
-                        astronauts[astronaut_count].type = type;
-                        astronauts[astronaut_count].current_building = buildings[i].id;
-                        astronauts[astronaut_count].target_module = -1;  // 목표 모듈은 동적으로 결정
-                        astronauts[astronaut_count].pod_id = -1;
-                        astronauts[astronaut_count].arrival_day = 0;
-                        astronauts[astronaut_count].arrived = false;
-                        astronaut_count++;
-                    }
-                }
-            }
+        // 새 경로와 모듈만 거리 표에 반영
+        PROFILE_END(PHASE_PARSE);
+        update_distances();
+        
+        // 새 착륙장이 들어온 달에만 출발 무리 갱신
+        if (start_groups_dirty) {
+            prepare_start_groups();
+            start_groups_dirty = false;
         }
         
         // 게임 전략 실행
-        execute_strategy(resources);
-        
-        // 우주비행사 이동 시뮬레이션 (텔레포터→포드 할당→우주비행사 할당→이동)
-        simulate_astronaut_movement();
+        execute_strategy(resources, turn_start_ms + (month == 0 ? FIRST_PLAN_TIME_MS : PLAN_TIME_MS));
     }
     
     return 0;
@@ -5,6 +5,10 @@
 #include <math.h>
 #include <float.h>
 
+#define MAX_NODES 200     // 창고 포함 최대 고객 수
+#define NEIGHBOR_COUNT 20 // 지역 탐색에서 살펴볼 가까운 고객 수
+#define MAX_SEGMENT 3     // Or-opt로 옮길 최대 연속 고객 수
+
 // 위치와 수요를 저장하는 구조체
 typedef struct {
     int index;
@@ -22,14 +26,6 @@ typedef struct {
     int total_distance;
 } Route;
 
-// k-d 트리 노드 구조체
-typedef struct kdnode {
-    Customer* customer;
-    int axis;
-    struct kdnode* left;
-    struct kdnode* right;
-} KDNode;
-
 // 저장(savings) 쌍 구조체
 typedef struct {
     int i;
@@ -37,6 +33,28 @@ typedef struct {
     double saving;
 } SavingsPair;
 
+// 미리 계산한 정수 거리와 가까운 고객 후보
+int distance_matrix[MAX_NODES][MAX_NODES];
+int neighbors[MAX_NODES][NEIGHBOR_COUNT];
+int neighbor_count;
+
+// 지역 탐색용 평면 경로 (경로마다 고객 배열, 고객마다 소속 경로와 위치)
+int demands[MAX_NODES];
+int vehicle_capacity;
+int tours[MAX_NODES][MAX_NODES];
+int tour_length[MAX_NODES];
+int tour_load[MAX_NODES];
+int tour_count;
+int route_of[MAX_NODES];
+int position[MAX_NODES];
+int prefix_load[MAX_NODES]; // 경로 시작부터 이 고객까지의 수요 합
+
+// don't-look 비트: 주변이 바뀐 고객만 대기열에 넣어 다시 살핌
+bool active[MAX_NODES];
+int active_queue[MAX_NODES];
+int active_head;
+int active_size;
+
 // 유클리드 거리 계산 함수
 int euclidean_distance(Customer* a, Customer* b) {
     double dx = a->x - b->x;
@@ -44,43 +62,32 @@ int euclidean_distance(Customer* a, Customer* b) {
     return (int)round(sqrt(dx * dx + dy * dy));
 }
 
-// k-d 트리 생성 함수
-KDNode* create_kdtree(Customer* customers, int n, int depth) {
-    if (n <= 0) return NULL;
-    
-    int axis = depth % 2; // 2차원이므로 0 또는 1
-    int median = n / 2;
-    
-    // axis에 따라 정렬 (간단한 삽입 정렬)
+// 모든 쌍의 거리를 한 번만 계산
+void build_distance_matrix(Customer* customers, int n) {
     for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-            if ((axis == 0 && customers[i].x > customers[j].x) ||
-                (axis == 1 && customers[i].y > customers[j].y)) {
-                Customer temp = customers[i];
-                customers[i] = customers[j];
-                customers[j] = temp;
-            }
+        for (int j = i; j < n; j++) {
+            distance_matrix[i][j] = distance_matrix[j][i] = euclidean_distance(&customers[i], &customers[j]);
         }
     }
-    
-    // 노드 생성
-    KDNode* node = (KDNode*)malloc(sizeof(KDNode));
-    node->customer = &customers[median];
-    node->axis = axis;
-    
-    // 재귀적으로 좌우 자식 생성
-    node->left = create_kdtree(customers, median, depth + 1);
-    node->right = create_kdtree(customers + median + 1, n - median - 1, depth + 1);
-    
-    return node;
 }
 
-// k-d 트리 메모리 해제
-void free_kdtree(KDNode* node) {
-    if (node == NULL) return;
-    free_kdtree(node->left);
-    free_kdtree(node->right);
-    free(node);
+// 고객마다 가장 가까운 고객 NEIGHBOR_COUNT명 (삽입 정렬로 유지)
+void build_neighbor_lists(int n) {
+    neighbor_count = n - 2 < NEIGHBOR_COUNT ? n - 2 : NEIGHBOR_COUNT;
+    for (int i = 1; i < n; i++) {
+        int count = 0;
+        for (int j = 1; j < n; j++) {
+            if (j == i) continue;
+            int d = distance_matrix[i][j];
+            if (count == neighbor_count && d >= distance_matrix[i][neighbors[i][count - 1]]) continue;
+            int k = count < neighbor_count ? count++ : count - 1;
+            while (k > 0 && distance_matrix[i][neighbors[i][k - 1]] > d) {
+                neighbors[i][k] = neighbors[i][k - 1];
+                k--;
+            }
+            neighbors[i][k] = j;
+        }
+    }
 }
 
 // 저장(savings) 값 계산을 위한 비교 함수
@@ -105,7 +112,7 @@ Route** clarke_wright_savings(Customer* customers, int n, int vehicle_capacity,
         routes[i]->count = 1;
         routes[i]->capacity = vehicle_capacity;
         routes[i]->total_demand = customers[i + 1].demand;
-        routes[i]->total_distance = 2 * euclidean_distance(&customers[0], &customers[i + 1]); // 왕복 거리
+        routes[i]->total_distance = 2 * distance_matrix[0][i + 1]; // 왕복 거리
     }
     
     // 모든 가능한 경로 쌍에 대한 저장(savings) 계산
@@ -115,9 +122,7 @@ Route** clarke_wright_savings(Customer* customers, int n, int vehicle_capacity,
     
     for (int i = 1; i < n; i++) {
         for (int j = i + 1; j < n; j++) {
-            double saving = euclidean_distance(&customers[0], &customers[i]) + 
-                           euclidean_distance(&customers[0], &customers[j]) - 
-                           euclidean_distance(&customers[i], &customers[j]);
+            double saving = distance_matrix[0][i] + distance_matrix[0][j] - distance_matrix[i][j];
             savings[idx].i = i;
             savings[idx].j = j;
             savings[idx].saving = saving;
@@ -224,10 +229,10 @@ Route** clarke_wright_savings(Customer* customers, int n, int vehicle_capacity,
             int prev = 0; // 창고
             for (int j = 0; j < routes[i]->count; j++) {
                 int curr = routes[i]->customers[j];
-                routes[i]->total_distance += euclidean_distance(&customers[prev], &customers[curr]);
+                routes[i]->total_distance += distance_matrix[prev][curr];
                 prev = curr;
             }
-            routes[i]->total_distance += euclidean_distance(&customers[prev], &customers[0]); // 창고로 돌아오기
+            routes[i]->total_distance += distance_matrix[prev][0]; // 창고로 돌아오기
             
             result_routes[result_count++] = routes[i];
         } else {
@@ -246,68 +251,263 @@ Route** clarke_wright_savings(Customer* customers, int n, int vehicle_capacity,
     return result_routes;
 }
 
-// 2-opt 개선 방법 구현
-void improve_route_with_2opt(Route* route, Customer* customers) {
-    bool improvement = true;
-    int n = route->count;
-    
-    while (improvement) {
-        improvement = false;
-        
-        for (int i = 0; i < n - 1; i++) {
-            for (int j = i + 1; j < n; j++) {
-                int cust_i = route->customers[i];
-                int cust_i_next = route->customers[(i + 1) % n];
-                int cust_j = route->customers[j];
-                int cust_j_next = route->customers[(j + 1) % n];
-                
-                // 현재 경로 거리
-                int current_distance = 
-                    euclidean_distance(&customers[cust_i], &customers[cust_i_next]) +
-                    euclidean_distance(&customers[cust_j], &customers[cust_j_next]);
-                
-                // 새 연결 거리
-                int new_distance = 
-                    euclidean_distance(&customers[cust_i], &customers[cust_j]) +
-                    euclidean_distance(&customers[cust_i_next], &customers[cust_j_next]);
-                
-                // 거리가 개선되면 경로 변경
-                if (new_distance < current_distance) {
-                    // i+1과 j 사이의 경로를 뒤집음
-                    int left = i + 1;
-                    int right = j;
-                    while (left < right) {
-                        int temp = route->customers[left];
-                        route->customers[left] = route->customers[right];
-                        route->customers[right] = temp;
-                        left++;
-                        right--;
-                    }
-                    
-                    // 총 거리 재계산
-                    route->total_distance = 0;
-                    int prev = 0; // 창고
-                    for (int k = 0; k < route->count; k++) {
-                        int curr = route->customers[k];
-                        route->total_distance += euclidean_distance(&customers[prev], &customers[curr]);
-                        prev = curr;
-                    }
-                    route->total_distance += euclidean_distance(&customers[prev], &customers[0]); // 창고로 돌아오기
-                    
-                    improvement = true;
-                    break;
-                }
+// ===== 지역 탐색 (평면 배열, 가까운 고객 후보, O(1) 변화량, don't-look 비트) =====
+
+// 경로 안의 앞뒤 고객 (경로 끝이면 창고 0)
+static inline int predecessor(int c) {
+    return position[c] == 0 ? 0 : tours[route_of[c]][position[c] - 1];
+}
+
+static inline int successor(int c) {
+    int r = route_of[c];
+    return position[c] == tour_length[r] - 1 ? 0 : tours[r][position[c] + 1];
+}
+
+// 경로 위치 i의 고객 (-1이나 끝을 넘으면 창고 0)
+static inline int node_at(int r, int i) {
+    return (i < 0 || i >= tour_length[r]) ? 0 : tours[r][i];
+}
+
+// 바뀐 경로의 위치, 소속, 누적 수요 다시 계산
+void refresh_tour(int r) {
+    int load = 0;
+    for (int i = 0; i < tour_length[r]; i++) {
+        int c = tours[r][i];
+        load += demands[c];
+        route_of[c] = r;
+        position[c] = i;
+        prefix_load[c] = load;
+    }
+    tour_load[r] = load;
+}
+
+void activate(int c) {
+    if (c == 0 || active[c]) return;
+    active[c] = true;
+    active_queue[(active_head + active_size++) % MAX_NODES] = c;
+}
+
+// 경로 r의 first 위치부터 length명을 (필요하면 뒤집어) 경로 target의 index 위치 앞에 삽입
+void move_segment(int r, int first, int length, bool reversed, int target, int index) {
+    int segment[MAX_SEGMENT];
+    for (int k = 0; k < length; k++) {
+        segment[k] = tours[r][reversed ? first + length - 1 - k : first + k];
+    }
+    memmove(&tours[r][first], &tours[r][first + length], (tour_length[r] - first - length) * sizeof(int));
+    tour_length[r] -= length;
+    if (target == r && index > first) {
+        index -= length;
+    }
+    memmove(&tours[target][index + length], &tours[target][index], (tour_length[target] - index) * sizeof(int));
+    memcpy(&tours[target][index], segment, length * sizeof(int));
+    tour_length[target] += length;
+    refresh_tour(r);
+    if (target != r) {
+        refresh_tour(target);
+    }
+}
+
+// relocate / Or-opt: u부터 length명을 v 앞이나 뒤로 옮김 (2명 이상이면 뒤집어 넣는 경우도)
+bool try_relocate(int u, int v, int length) {
+    int ru = route_of[u], rv = route_of[v];
+    int first = position[u];
+    int last = first + length - 1;
+    if (last >= tour_length[ru]) return false;
+    if (ru == rv && position[v] >= first && position[v] <= last) return false;
+
+    int segment_demand = prefix_load[tours[ru][last]] - prefix_load[u] + demands[u];
+    if (ru != rv && tour_load[rv] + segment_demand > vehicle_capacity) return false;
+
+    int s1 = u, s2 = tours[ru][last];
+    int p = predecessor(s1), q = successor(s2);
+    int removal = distance_matrix[p][q] - distance_matrix[p][s1] - distance_matrix[s2][q];
+
+    for (int spot = 0; spot < 2; spot++) {
+        // spot 0: v 앞 (pred(v), v), spot 1: v 뒤 (v, succ(v))
+        int a = spot == 0 ? predecessor(v) : v;
+        int b = spot == 0 ? v : successor(v);
+        if (ru == rv && ((a != 0 && position[a] >= first && position[a] <= last) ||
+                         (b != 0 && position[b] >= first && position[b] <= last))) continue;
+        for (int reversed = 0; reversed < (length > 1 ? 2 : 1); reversed++) {
+            int x = reversed ? s2 : s1, y = reversed ? s1 : s2;
+            int delta = removal + distance_matrix[a][x] + distance_matrix[y][b] - distance_matrix[a][b];
+            if (delta < 0) {
+                move_segment(ru, first, length, reversed, rv, spot == 0 ? position[v] : position[v] + 1);
+                activate(p); activate(q); activate(a); activate(b);
+                activate(s1); activate(s2);
+                return true;
             }
-            if (improvement) break;
         }
     }
+    return false;
 }
 
-// 모든 경로에 2-opt 개선 적용
-void improve_routes_with_2opt(Route** routes, int route_count, Customer* customers) {
-    for (int i = 0; i < route_count; i++) {
-        improve_route_with_2opt(routes[i], customers);
+// 같은 경로 2-opt: u와 v를 잇고 사이 구간을 뒤집음 (뒤 고객끼리 또는 앞 고객끼리 잇는 두 경우)
+bool try_two_opt(int u, int v) {
+    int r = route_of[u];
+    if (route_of[v] != r) return false;
+    int i = position[u] < position[v] ? position[u] : position[v];
+    int j = position[u] < position[v] ? position[v] : position[u];
+
+    for (int variant = 0; variant < 2; variant++) {
+        // variant 0: 간선 (i, i+1), (j, j+1) -> (i, j), (i+1, j+1), i+1..j 뒤집기
+        // variant 1: 간선 (i-1, i), (j-1, j) -> (i-1, j-1), (i, j), i..j-1 뒤집기
+        int a = variant == 0 ? i : i - 1;
+        int b = variant == 0 ? j : j - 1;
+        int na = node_at(r, a), nsa = node_at(r, a + 1);
+        int nb = node_at(r, b), nsb = node_at(r, b + 1);
+        if (b <= a + 1) continue;
+        int delta = distance_matrix[na][nb] + distance_matrix[nsa][nsb]
+                  - distance_matrix[na][nsa] - distance_matrix[nb][nsb];
+        if (delta < 0) {
+            for (int left = a + 1, right = b; left < right; left++, right--) {
+                int temp = tours[r][left];
+                tours[r][left] = tours[r][right];
+                tours[r][right] = temp;
+            }
+            refresh_tour(r);
+            activate(na); activate(nsa); activate(nb); activate(nsb);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 두 경로를 A의 위치 i 뒤, B의 위치 j 뒤에서 잘라 꼬리를 교환 (crossed면 머리끼리, 꼬리끼리 뒤집어 이음)
+//   교환: A' = A[..i] + B[j+1..], B' = B[..j] + A[i+1..]
+//   뒤집기: A' = A[..i] + rev(B[..j]), B' = rev(A[i+1..]) + B[j+1..]
+void exchange_tails(int ra, int i, int rb, int j, bool crossed) {
+    int new_a[MAX_NODES], new_b[MAX_NODES];
+    int length_a = 0, length_b = 0;
+    for (int k = 0; k <= i; k++) new_a[length_a++] = tours[ra][k];
+    if (crossed) {
+        for (int k = j; k >= 0; k--) new_a[length_a++] = tours[rb][k];
+        for (int k = tour_length[ra] - 1; k > i; k--) new_b[length_b++] = tours[ra][k];
+    } else {
+        for (int k = j + 1; k < tour_length[rb]; k++) new_a[length_a++] = tours[rb][k];
+        for (int k = 0; k <= j; k++) new_b[length_b++] = tours[rb][k];
+        for (int k = i + 1; k < tour_length[ra]; k++) new_b[length_b++] = tours[ra][k];
+    }
+    if (crossed) {
+        for (int k = j + 1; k < tour_length[rb]; k++) new_b[length_b++] = tours[rb][k];
+    }
+    memcpy(tours[ra], new_a, length_a * sizeof(int));
+    memcpy(tours[rb], new_b, length_b * sizeof(int));
+    tour_length[ra] = length_a;
+    tour_length[rb] = length_b;
+    refresh_tour(ra);
+    refresh_tour(rb);
+}
+
+// 위치 i까지의 누적 수요 (i가 -1이면 0)
+static inline int load_through(int r, int i) {
+    return i < 0 ? 0 : prefix_load[tours[r][i]];
+}
+
+// 경로 간 2-opt*: 간선 (u, v)를 만드는 꼬리 교환과 뒤집어 잇기
+bool try_two_opt_star(int u, int v) {
+    int ra = route_of[u], rb = route_of[v];
+    if (ra == rb) return false;
+
+    // (i, j, crossed): u -> v 교환, v -> u 교환, (u, v)와 (su, sv) 잇기, (pu, pv)와 (u, v) 잇기
+    int cuts[4][3] = {
+        {position[u], position[v] - 1, 0},
+        {position[u] - 1, position[v], 0},
+        {position[u], position[v], 1},
+        {position[u] - 1, position[v] - 1, 1},
+    };
+    for (int k = 0; k < 4; k++) {
+        int i = cuts[k][0], j = cuts[k][1];
+        bool crossed = cuts[k][2];
+        int x = node_at(ra, i), sx = node_at(ra, i + 1);
+        int y = node_at(rb, j), sy = node_at(rb, j + 1);
+        int head_a = load_through(ra, i), head_b = load_through(rb, j);
+        int tail_a = tour_load[ra] - head_a, tail_b = tour_load[rb] - head_b;
+        int delta;
+        if (crossed) {
+            if (head_a + head_b > vehicle_capacity || tail_a + tail_b > vehicle_capacity) continue;
+            delta = distance_matrix[x][y] + distance_matrix[sx][sy];
+        } else {
+            if (head_a + tail_b > vehicle_capacity || head_b + tail_a > vehicle_capacity) continue;
+            delta = distance_matrix[x][sy] + distance_matrix[y][sx];
+        }
+        delta -= distance_matrix[x][sx] + distance_matrix[y][sy];
+        if (delta < 0) {
+            exchange_tails(ra, i, rb, j, crossed);
+            activate(x); activate(sx); activate(y); activate(sy);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 고객 u 주변의 가까운 고객들과 이동을 시도해 처음 찾은 개선을 적용
+bool improve_customer(int u) {
+    for (int k = 0; k < neighbor_count; k++) {
+        int v = neighbors[u][k];
+        for (int length = 1; length <= MAX_SEGMENT; length++) {
+            if (try_relocate(u, v, length)) return true;
+        }
+        if (try_two_opt(u, v) || try_two_opt_star(u, v)) return true;
+    }
+    return false;
+}
+
+// 모든 고객을 대기열에 넣고, 개선이 일어난 주변 고객만 다시 살피며 더 이상 개선이 없을 때까지 반복
+void local_search(int n) {
+    active_head = 0;
+    active_size = 0;
+    for (int c = 1; c < n; c++) {
+        active[c] = false;
+        activate(c);
+    }
+    while (active_size > 0) {
+        int u = active_queue[active_head];
+        active_head = (active_head + 1) % MAX_NODES;
+        active_size--;
+        active[u] = false;
+        if (improve_customer(u)) {
+            activate(u);
+        }
+    }
+}
+
+// Clarke-Wright 결과를 평면 배열로
+void load_tours(Route** routes, int route_count, Customer* customers, int capacity) {
+    vehicle_capacity = capacity;
+    tour_count = route_count;
+    demands[0] = 0;
+    for (int r = 0; r < route_count; r++) {
+        tour_length[r] = routes[r]->count;
+        for (int k = 0; k < routes[r]->count; k++) {
+            int c = routes[r]->customers[k];
+            tours[r][k] = c;
+            demands[c] = customers[c].demand;
+        }
+        refresh_tour(r);
+    }
+}
+
+// 평면 배열을 경로 구조체로 되돌림 (비어 버린 경로는 해제)
+void store_tours(Route** routes, int* route_count) {
+    int kept = 0;
+    for (int r = 0; r < tour_count; r++) {
+        if (tour_length[r] == 0) continue;
+        Route* route = routes[kept++];
+        route->customers = (int*)realloc(route->customers, tour_length[r] * sizeof(int));
+        memcpy(route->customers, tours[r], tour_length[r] * sizeof(int));
+        route->count = tour_length[r];
+        route->total_demand = tour_load[r];
+        route->total_distance = distance_matrix[0][tours[r][0]] + distance_matrix[tours[r][tour_length[r] - 1]][0];
+        for (int k = 1; k < tour_length[r]; k++) {
+            route->total_distance += distance_matrix[tours[r][k - 1]][tours[r][k]];
+        }
+    }
+    for (int r = kept; r < *route_count; r++) {
+        free(routes[r]->customers);
+        free(routes[r]);
     }
+    *route_count = kept;
 }
 
 /**
@@ -343,15 +543,17 @@ int main()
         customers[i].demand = demand;
     }
     
-    // k-d 트리 생성 (필요시 사용)
-    KDNode* kdtree = create_kdtree(customers + 1, n - 1, 0);
+    build_distance_matrix(customers, n);
+    build_neighbor_lists(n);
     
     // Clarke-Wright 저장 알고리즘으로 초기 경로 생성
     int route_count;
     Route** routes = clarke_wright_savings(customers, n, c, &route_count);
     
-    // 2-opt 개선 방법으로 경로 최적화
-    improve_routes_with_2opt(routes, route_count, customers);
+    // 지역 탐색(relocate, Or-opt, 2-opt, 2-opt*)으로 경로 최적화
+    load_tours(routes, route_count, customers, c);
+    local_search(n);
+    store_tours(routes, &route_count);
     
     // 결과 출력
     char output[10000] = "";
@@ -372,7 +574,6 @@ int main()
     printf("%s\n", output);
     
     // 메모리 해제
-    free_kdtree(kdtree);
     for (int i = 0; i < route_count; i++) {
         free(routes[i]->customers);
         free(routes[i]);